@@ -13,6 +13,13 @@
 
 namespace PathAlgorithm
 {
+	namespace
+	{
+		/**
+		 * The number of search iterations between 2 looks at the cancellation token
+		 */
+		const unsigned long CancellationCheckInterval = 64;
+	} // namespace
 	/**
 	 *
 	 */
@@ -52,13 +59,16 @@ namespace PathAlgorithm
 	 *
 	 */
 	std::vector< Vertex > GetNeighbours(	const Vertex& aVertex,
-											int aFreeRadius /*= 1*/)
+											int aFreeRadius,
+											const Model::WorldSnapshot& aWorld)
 	{
 		static const int xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
 		static const int yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
 
-		const std::vector< Model::WallPtr >& walls = Model::RobotWorld::getRobotWorld().getWalls();
-		const std::vector< Model::RobotPtr>& robots = Model::RobotWorld::getRobotWorld().getRobots();
+		static const Base::SymbolId butterName = Base::SymbolTable::intern( "Butter");
+
+		const std::vector< Model::WallPtr >& walls = aWorld.walls;
+		const std::vector< Model::RobotPtr>& robots = aWorld.robots;
 		std::vector< Vertex > neighbours;
 
 		for (int i = 0; i < 8; ++i)
@@ -76,7 +86,7 @@ namespace PathAlgorithm
 			}
 
 			for (Model::RobotPtr robot : robots) {
-				if (robot->getName() == "Butter") continue;
+				if (robot->getNameId() == butterName) continue;
 				if (Utils::Shape2DUtils::isOnLine( robot->getFrontLeft(), robot->getFrontRight(), vertex.asPoint(), aFreeRadius) ||
 				  Utils::Shape2DUtils::isOnLine( robot->getFrontLeft(), robot->getBackLeft(), vertex.asPoint(), aFreeRadius) ||
 				  Utils::Shape2DUtils::isOnLine( robot->getFrontRight(), robot->getBackRight(), vertex.asPoint(), aFreeRadius) ||
@@ -96,11 +106,12 @@ namespace PathAlgorithm
 	 *
 	 */
 	std::vector< Edge > GetNeighbourConnections(	const Vertex& aVertex,
-													int aFreeRadius /*= 1*/)
+													int aFreeRadius,
+													const Model::WorldSnapshot& aWorld)
 	{
 		std::vector< Edge > connections;
 
-		const std::vector< Vertex >& neighbours = GetNeighbours( aVertex, aFreeRadius);
+		const std::vector< Vertex >& neighbours = GetNeighbours( aVertex, aFreeRadius, aWorld);
 		for (const Vertex& vertex : neighbours)
 		{
 			connections.push_back( Edge( aVertex, vertex));
@@ -113,12 +124,13 @@ namespace PathAlgorithm
 	 */
 	Path AStar::search(	const wxPoint& aStartPoint,
 						const wxPoint& aGoalPoint,
-						const wxSize& aRobotSize)
+						const wxSize& aRobotSize,
+						const Base::CancellationToken& aCancellationToken /*= Base::CancellationToken()*/)
 	{
 		Vertex start( aStartPoint);
 		Vertex goal( aGoalPoint);
 
-		Path path = AStar::search( start, goal, aRobotSize);
+		Path path = AStar::search( start, goal, aRobotSize, aCancellationToken);
 		return path;
 	}
 	/**
@@ -126,7 +138,8 @@ namespace PathAlgorithm
 	 */
 	Path AStar::search( Vertex aStart,
 						const Vertex& aGoal,
-						const wxSize& aRobotSize)
+						const wxSize& aRobotSize,
+						const Base::CancellationToken& aCancellationToken /*= Base::CancellationToken()*/)
 	{
 		getOS().clear();
 		getCS().clear();
@@ -139,10 +152,21 @@ namespace PathAlgorithm
 
 		addToOpenSet(aStart);
 
+		// The whole search plans against one version of the world, walls and robots that are
+		// added or removed while searching are seen by the next search
+		Model::WorldSnapshotPtr world = Model::RobotWorld::getRobotWorld().getSnapshot();
+
 		// Keep the timing stuff, please.
 //		clock_t start = std::clock();
+		unsigned long iterations = 0;
 		while (!openSet.empty())
 		{
+			// Looking at the clock for the deadline on every iteration would cost more than the iteration itself
+			if ((++iterations % CancellationCheckInterval) == 0 && aCancellationToken.isCancelled())
+			{
+				return Path();
+			}
+
 			// The openSet should be sorted by cost, least cost must be the first
 			Vertex current = *openSet.begin();
 
@@ -157,7 +181,7 @@ namespace PathAlgorithm
 				addToClosedSet( current);
 
 				// Find all the outgoing connections for the current Vertex
-				const std::vector< Edge >& connections = GetNeighbourConnections( current, radius);
+				const std::vector< Edge >& connections = GetNeighbourConnections( current, radius, *world);
 
 				for (const Edge& connection : connections)
 				{
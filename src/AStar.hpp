@@ -3,6 +3,7 @@
 
 #include "Config.hpp"
 
+#include "CancellationToken.hpp"
 #include "Notifier.hpp"
 #include "Point.hpp"
 
@@ -209,16 +210,20 @@ namespace PathAlgorithm
 		public:
 			/**
 			 *
+			 * @return an empty path if there is no route or if aCancellationToken was cancelled or expired during the search
 			 */
 			Path search(const wxPoint& aStartPoint,
 						const wxPoint& aGoalPoint,
-						const wxSize& aRobotSize);
+						const wxSize& aRobotSize,
+						const Base::CancellationToken& aCancellationToken = Base::CancellationToken());
 			/**
 			 *
+			 * @return an empty path if there is no route or if aCancellationToken was cancelled or expired during the search
 			 */
 			Path search(Vertex aStart,
 						const Vertex& aGoal,
-						const wxSize& aRobotSize);
+						const wxSize& aRobotSize,
+						const Base::CancellationToken& aCancellationToken = Base::CancellationToken());
 			/**
 			 *
 			 */
@@ -0,0 +1,98 @@
+#ifndef ADDRESS_HPP_
+#define ADDRESS_HPP_
+
+#include "Config.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace Messaging
+{
+	/**
+	 * The address of a Server: a TCP host and port or the path of a Unix domain socket.
+	 *
+	 * The string form is URI-like:
+	 *
+	 *  tcp://host:port        a TCP connection, "host:port" without the scheme is accepted as well
+	 *  unix:///path/to/socket a Unix domain socket, only for processes on the same host
+	 */
+	struct Address
+	{
+			/**
+			 *
+			 */
+			Address() :
+						port( 0)
+			{
+			}
+			/**
+			 *
+			 */
+			Address(	const std::string& aHostName,
+						unsigned short aPort) :
+							host( aHostName),
+							port( aPort)
+			{
+			}
+			/**
+			 *
+			 */
+			static Address local( const std::string& aSocketPath)
+			{
+				Address address;
+				address.socketPath = aSocketPath;
+				return address;
+			}
+			/**
+			 * @throw std::invalid_argument if aString is not in one of the forms above
+			 */
+			static Address parse( const std::string& aString)
+			{
+				if (aString.compare( 0, unixScheme.length(), unixScheme) == 0)
+				{
+					if (aString.length() == unixScheme.length())
+					{
+						throw std::invalid_argument( "Address::parse: no socket path in " + aString);
+					}
+					return local( aString.substr( unixScheme.length()));
+				}
+
+				const std::string hostAndPort = aString.compare( 0, tcpScheme.length(), tcpScheme) == 0 ? aString.substr( tcpScheme.length()) : aString;
+				const std::size_t colon = hostAndPort.rfind( ':');
+				if (colon == std::string::npos || colon == 0 || colon + 1 == hostAndPort.length() || hostAndPort.find_first_not_of( "0123456789", colon + 1) != std::string::npos)
+				{
+					throw std::invalid_argument( "Address::parse: expected tcp://host:port or unix:///path instead of " + aString);
+				}
+				const unsigned long port = std::stoul( hostAndPort.substr( colon + 1));
+				if (port == 0 || port > 65535) // @suppress("Avoid magic numbers")
+				{
+					throw std::invalid_argument( "Address::parse: invalid port in " + aString);
+				}
+				return Address( hostAndPort.substr( 0, colon), static_cast< unsigned short >( port));
+			}
+			/**
+			 * @return true for a Unix domain socket
+			 */
+			bool isLocal() const
+			{
+				return !socketPath.empty();
+			}
+			/**
+			 * @return The URI-like form that parse() accepts
+			 */
+			std::string asString() const
+			{
+				return isLocal() ? unixScheme + socketPath : tcpScheme + host + ":" + std::to_string( port);
+			}
+
+			std::string host;
+			unsigned short port;
+			std::string socketPath;
+
+			inline static const std::string tcpScheme = "tcp://";
+			inline static const std::string unixScheme = "unix://";
+	};
+	// struct Address
+} // namespace Messaging
+
+#endif // ADDRESS_HPP_
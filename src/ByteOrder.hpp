@@ -0,0 +1,83 @@
+#ifndef BYTEORDER_HPP_
+#define BYTEORDER_HPP_
+
+#include "Config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Base
+{
+	/**
+	 * The wire formats are little-endian. These functions copy a number in or out of a byte buffer
+	 * with memcpy, so the buffer needs no alignment, and only swap bytes on big-endian hosts.
+	 */
+	template< typename T >
+	T toLittleEndian( T aValue)
+	{
+		static_assert( std::is_integral< T >::value, "toLittleEndian needs an integral type");
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		T result = 0;
+		for (std::size_t i = 0; i < sizeof( T); ++i)
+		{
+			result = static_cast< T >( (result << 8) | (aValue & 0xFF)); // @suppress("Avoid magic numbers")
+			aValue = static_cast< T >( aValue >> 8); // @suppress("Avoid magic numbers")
+		}
+		return result;
+#else
+		return aValue;
+#endif
+	}
+	/**
+	 *
+	 */
+	template< typename T >
+	T fromLittleEndian( T aValue)
+	{
+		return toLittleEndian( aValue);
+	}
+	/**
+	 * Writes aValue into the sizeof( T) bytes at aBuffer
+	 */
+	template< typename T >
+	void storeLittleEndian(	char* aBuffer,
+							T aValue)
+	{
+		const T value = toLittleEndian( aValue);
+		std::memcpy( aBuffer, &value, sizeof( value));
+	}
+	/**
+	 * Reads a T from the sizeof( T) bytes at aBuffer
+	 */
+	template< typename T >
+	T loadLittleEndian( const char* aBuffer)
+	{
+		T value;
+		std::memcpy( &value, aBuffer, sizeof( value));
+		return fromLittleEndian( value);
+	}
+	/**
+	 * A float travels as the little-endian bits of its IEEE 754 representation
+	 */
+	inline void storeLittleEndian(	char* aBuffer,
+									float aValue)
+	{
+		static_assert( sizeof( float) == sizeof( std::uint32_t), "float must be 32 bits");
+		std::uint32_t bits;
+		std::memcpy( &bits, &aValue, sizeof( bits));
+		storeLittleEndian( aBuffer, bits);
+	}
+	/**
+	 *
+	 */
+	inline float loadLittleEndianFloat( const char* aBuffer)
+	{
+		const std::uint32_t bits = loadLittleEndian< std::uint32_t >( aBuffer);
+		float value;
+		std::memcpy( &value, &bits, sizeof( value));
+		return value;
+	}
+} // namespace Base
+#endif // BYTEORDER_HPP_
@@ -0,0 +1,83 @@
+#ifndef CANCELLATIONTOKEN_HPP_
+#define CANCELLATIONTOKEN_HPP_
+
+#include "Config.hpp"
+
+#include <atomic>
+#include <chrono>
+
+namespace Base
+{
+	/**
+	 * Lets long running work, e.g. a route calculation, find out that its result is no longer wanted,
+	 * either because somebody cancelled it or because its deadline passed. The work polls isCancelled().
+	 *
+	 * The deadline is a budget of real time on std::chrono::steady_clock and not on the Base::Clock: the
+	 * work takes as much CPU time when the simulation runs in virtual time, where the Clock may run far
+	 * ahead of it.
+	 */
+	class CancellationToken
+	{
+		public:
+			/**
+			 * A token without a deadline
+			 */
+			CancellationToken() :
+								cancelled( false),
+								hasDeadline( false)
+			{
+			}
+			/**
+			 *
+			 */
+			explicit CancellationToken( const std::chrono::steady_clock::time_point& aDeadline) :
+								cancelled( false),
+								hasDeadline( true),
+								deadline( aDeadline)
+			{
+			}
+			/**
+			 *
+			 */
+			CancellationToken( const CancellationToken& aCancellationToken) = delete;
+			/**
+			 *
+			 */
+			CancellationToken& operator=( const CancellationToken& aCancellationToken) = delete;
+			/**
+			 *
+			 */
+			void cancel()
+			{
+				cancelled = true;
+			}
+			/**
+			 * @return true if cancel() was called or the deadline passed
+			 */
+			bool isCancelled() const
+			{
+				return isCancelRequested() || isExpired();
+			}
+			/**
+			 *
+			 */
+			bool isCancelRequested() const
+			{
+				return cancelled;
+			}
+			/**
+			 *
+			 */
+			bool isExpired() const
+			{
+				return hasDeadline && std::chrono::steady_clock::now() >= deadline;
+			}
+
+		private:
+			std::atomic< bool > cancelled;
+			const bool hasDeadline;
+			const std::chrono::steady_clock::time_point deadline;
+	};
+	// class CancellationToken
+} // namespace Base
+#endif // CANCELLATIONTOKEN_HPP_
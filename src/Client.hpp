@@ -3,7 +3,7 @@
 
 #include "Config.hpp"
 
-#include "Session.hpp"
+#include "Connection.hpp"
 
 #include <string>
 
@@ -21,130 +21,54 @@ namespace Messaging
 			Client( const std::string& aHostName,
 					unsigned short aPort,
 					ResponseHandlerPtr aResponseHandler) :
-							host( aHostName),
-							port( aPort),
+							address( aHostName, aPort),
 							responseHandler( aResponseHandler)
 			{
 			}
 			/**
-			 * Dispatch the message to the client's remote server
+			 * @param anAddress a TCP host and port or the path of a Unix domain socket
+			 */
+			Client( const Address& anAddress,
+					ResponseHandlerPtr aResponseHandler) :
+							address( anAddress),
+							responseHandler( aResponseHandler)
+			{
+			}
+			/**
+			 * Dispatch the message to the client's remote server.
+			 *
+			 * The message goes over the persistent Connection to the address that is shared by all
+			 * Clients of that server, so creating a Client per message is cheap: there is no
+			 * resolve, connect or teardown per message.
 			 *
 			 * @startuml
 			 * -> client: dispatchMessage(message)
 			 * activate client
-			 * client -->> session
-			 * activate session
-			 * deactivate session
-			 * client -->> endpoint
-			 * client -\ socket: async_connect(endpoint,(){handleConnect();})
+			 * client -> communicationService : getConnection(address)
+			 * client -> connection : dispatchMessage(message,responseHandler)
+			 * connection -\ io_context : post(){push request; sendNextRequest();}
 			 * <-- client
 			 * deactivate client
-			 * client <- socket : handleConnect(session,error)
-			 * activate socket
-			 * activate client
-			 * client -> session :start
-			 * deactivate client
-			 * deactivate socket
-			 * activate session
-			 * == Writing the request ==
-			 * session -> session: writeMessage(message)
-			 * activate session
-			 * session -\ socket: async_write(socket,messageHeaderBuffer,(){handleHeaderWriten();})
-			 * deactivate session
-			 * activate socket
-			 * client <-- session
-			 * deactivate session
-			 * session <- socket : handleHeaderWriten()
-			 * deactivate socket
-			 * activate session
-			 * session -\ socket: async_write(socket,messageBodyBuffer,(){handleBodyWriten();})
-			 * deactivate session
-			 * activate socket
-			 * session <- socket : handleBodyWriten()
-			 * deactivate socket
-			 * activate session
-			 * session -> session : handleMessageWritten(error)
-			 * activate session
-			 * session -> session : handleMessageWritten()
-			 * activate session
-			 * == Reading the response ==
-			 * session -> session: readMessage
-			 * activate session
-			 * session -\ socket: async_read(socket messageHeaderBuffer, (){handleHeaderRead();})
-			 * deactivate session
-			 * activate socket
-			 * deactivate session
-			 * deactivate session
-			 * deactivate session
-			 * session <- socket : handleHeaderRead(message,error)
-			 * deactivate socket
-			 * activate session
-			 * session -\ socket: async_read(socket messageBodyBuffer,(){handleBodyRead();})
-			 * deactivate session
-			 * activate socket
-			 * session <- socket : handleBodyRead()
-			 * deactivate socket
-			 * activate session
-			 * session -> session : handleMessageRead(error)
-			 * activate session
-			 * session -> session : handleMessageRead()
-			 * activate session
-			 * == Handling the response ==
-			 * session -> responseHandler: handleResponse(message)
-			 * activate responseHandler
-			 * session <-- responseHandler
-			 * deactivate responseHandler
-			 * deactivate session
-			 * deactivate session
-			 * destroy session
+			 * == On the io_context thread ==
+			 * connection -> connection : sendNextRequest
+			 * activate connection
+			 * connection -\ socket: async_connect(endpoint) if not connected yet
+			 * connection -> connection : writeMessage(message)
+			 * connection -> connection : readMessage
+			 * connection -> responseHandler: handleResponse(message)
+			 * connection -> connection : sendNextRequest if there are more requests
+			 * deactivate connection
 			 * @enduml
 			 */
 			void dispatchMessage( const Message& aMessage)
 			{
-				// Create the session that will handle the next outgoing connection
-				ClientSession* session = new ClientSession( aMessage,
-															responseHandler);
-
-				// Build up the remote address to which we will connect
-				boost::asio::ip::tcp::resolver resolver( CommunicationService::getCommunicationService().getIOContext()); // @suppress("Ambiguous problem")
-				boost::asio::ip::tcp::resolver::query query( boost::asio::ip::tcp::v4(), host, std::to_string(port));
-				boost::asio::ip::tcp::resolver::iterator endpoint_iterator = resolver.resolve( query);
-				boost::asio::ip::tcp::endpoint endpoint = *endpoint_iterator;
-
-				// Let the session handle any outgoing messages
-				session->getSocket().async_connect( endpoint, // @suppress("Method cannot be resolved") // @suppress("Invalid arguments")
-													[session](const boost::system::error_code& error)
-													{
-														Client::handleConnect(session, error);
-													});
+				CommunicationService::getCommunicationService().getConnection( address)->dispatchMessage( aMessage, responseHandler);
 			}
 		private:
 			/**
 			 *
 			 */
-			static void handleConnect( ClientSession* aSession,
-									   const boost::system::error_code& error)
-			{
-				if (!error)
-				{
-					aSession->start();
-				} else
-				{
-					std::ostringstream os;
-					os << __PRETTY_FUNCTION__ << ": error connecting to " << aSession->getSocket().remote_endpoint().address().to_string() << ":" << aSession->getSocket().remote_endpoint().port() << ", reason: " << error.message();
-					TRACE_DEVELOP(os.str());
-
-					delete aSession;
-				}
-			}
-			/**
-			 *
-			 */
-			std::string host;
-			/**
-			 *
-			 */
-			unsigned short port;
+			Address address;
 			/**
 			 *
 			 */
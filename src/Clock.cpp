@@ -0,0 +1,89 @@
+#include "Clock.hpp"
+
+#include <thread>
+
+namespace Base
+{
+	/**
+	 *
+	 */
+	/* static */Clock& Clock::getClock()
+	{
+		static Clock clock;
+		return clock;
+	}
+	/**
+	 *
+	 */
+	void Clock::setMode( Mode aMode)
+	{
+		if (aMode == VirtualTime && mode != VirtualTime)
+		{
+			virtualNow = std::chrono::steady_clock::now().time_since_epoch().count();
+		}
+		mode = aMode;
+	}
+	/**
+	 *
+	 */
+	Clock::TimePoint Clock::now() const
+	{
+		if (mode == VirtualTime)
+		{
+			return TimePoint( Duration( virtualNow.load()));
+		}
+		return std::chrono::steady_clock::now();
+	}
+	/**
+	 *
+	 */
+	void Clock::sleepUntil( const TimePoint& aTimePoint)
+	{
+		if (mode == VirtualTime)
+		{
+			advanceTo( aTimePoint);
+			// Give other threads the chance to run, as they would have during a real sleep
+			std::this_thread::yield();
+			return;
+		}
+		std::this_thread::sleep_until( aTimePoint);
+	}
+	/**
+	 *
+	 */
+	void Clock::sleepFor( const Duration& aDuration)
+	{
+		sleepUntil( now() + aDuration);
+	}
+	/**
+	 *
+	 */
+	Clock::Duration Clock::getTimerDelay( const Duration& aDelay)
+	{
+		if (mode == VirtualTime)
+		{
+			return Duration::zero();
+		}
+		return aDelay;
+	}
+	/**
+	 *
+	 */
+	Clock::Clock() :
+								mode( RealTime),
+								virtualNow( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	void Clock::advanceTo( const TimePoint& aTimePoint)
+	{
+		Duration::rep target = aTimePoint.time_since_epoch().count();
+		Duration::rep current = virtualNow.load();
+		// Time never goes back, even if more threads advance it concurrently
+		while (current < target && !virtualNow.compare_exchange_weak( current, target))
+		{
+		}
+	}
+} // namespace Base
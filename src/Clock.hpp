@@ -0,0 +1,101 @@
+#ifndef CLOCK_HPP_
+#define CLOCK_HPP_
+
+#include "Config.hpp"
+
+#include <atomic>
+#include <chrono>
+
+namespace Base
+{
+	/**
+	 * All sleeps and timers of the application go through the Clock so the simulation can run
+	 * in virtual time.
+	 *
+	 * In RealTime mode the Clock is std::chrono::steady_clock. In VirtualTime mode a sleep does not
+	 * block but advances the virtual time to the requested wake up time, so a simulation runs as fast
+	 * as the CPU allows while everything that measures time with the Clock still sees the simulated
+	 * durations. Timer delays are returned as zero but do not advance the virtual time: only the
+	 * simulation does, a network timer must not make the simulated time jump.
+	 */
+	class Clock
+	{
+		public:
+			/**
+			 *
+			 */
+			typedef std::chrono::steady_clock::duration Duration;
+			/**
+			 *
+			 */
+			typedef std::chrono::steady_clock::time_point TimePoint;
+			/**
+			 *
+			 */
+			enum Mode
+			{
+				RealTime,
+				VirtualTime
+			};
+			/**
+			 *
+			 */
+			static Clock& getClock();
+			/**
+			 *
+			 */
+			Mode getMode() const
+			{
+				return mode;
+			}
+			/**
+			 * Switching to VirtualTime starts the virtual time at the current real time so
+			 * now() stays monotonic.
+			 */
+			void setMode( Mode aMode);
+			/**
+			 *
+			 */
+			TimePoint now() const;
+			/**
+			 *
+			 */
+			void sleepUntil( const TimePoint& aTimePoint);
+			/**
+			 *
+			 */
+			void sleepFor( const Duration& aDuration);
+			/**
+			 * To be used for the expiry time of asynchronous timers.
+			 *
+			 * @return aDelay in RealTime mode, 0 in VirtualTime mode
+			 */
+			Duration getTimerDelay( const Duration& aDelay);
+
+		protected:
+			/**
+			 *
+			 */
+			Clock();
+			/**
+			 *
+			 */
+			virtual ~Clock() = default;
+
+		private:
+			/**
+			 * Advances the virtual time to aTimePoint if it is later than the current virtual time
+			 */
+			void advanceTo( const TimePoint& aTimePoint);
+			/**
+			 *
+			 */
+			std::atomic< Mode > mode;
+			/**
+			 * The virtual time since the epoch of steady_clock, in Duration ticks
+			 */
+			std::atomic< Duration::rep > virtualNow;
+	};
+	// class Clock
+} // namespace Base
+#endif // CLOCK_HPP_
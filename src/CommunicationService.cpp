@@ -1,11 +1,19 @@
 #include "CommunicationService.hpp"
 
+#include "Clock.hpp"
+#include "Connection.hpp"
 #include "Server.hpp"
+#include "TelemetryReceiver.hpp"
+#include "TelemetrySender.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <sstream>
 
 namespace Messaging
 {
+	/* static */std::atomic< std::size_t > CommunicationService::numberOfThreads( 0);
+	/* static */std::atomic< bool > CommunicationService::sharedMemoryEnabled( true);
 	/**
 	 *
 	 */
@@ -14,6 +22,35 @@ namespace Messaging
 		static CommunicationService communicationService;
 		return communicationService;
 	}
+	/**
+	 *
+	 */
+	/* static */void CommunicationService::setNumberOfThreads( std::size_t aNumberOfThreads)
+	{
+		numberOfThreads.store( aNumberOfThreads);
+	}
+	/**
+	 *
+	 */
+	/* static */std::size_t CommunicationService::getNumberOfThreads()
+	{
+		const std::size_t threads = numberOfThreads.load();
+		return threads != 0 ? threads : std::max( 1U, std::thread::hardware_concurrency());
+	}
+	/**
+	 *
+	 */
+	/* static */void CommunicationService::setSharedMemoryEnabled( bool anEnabled)
+	{
+		sharedMemoryEnabled.store( anEnabled);
+	}
+	/**
+	 *
+	 */
+	/* static */bool CommunicationService::isSharedMemoryEnabled()
+	{
+		return sharedMemoryEnabled.load();
+	}
 	/**
 	 *
 	 */
@@ -21,15 +58,15 @@ namespace Messaging
 											  bool start /* = true */)
 	{
 		// TODO Should this be an assert during development only in the limited context of this example?
-		auto result = servers.find(aServer->getPort());
+		auto result = servers.find(serverKey(aServer->getAddress()));
 		if(result != servers.end())
 		{
 			std::ostringstream os;
-			os << __PRETTY_FUNCTION__ << ": only one server per port allowed, port = " << aServer->getPort();
+			os << __PRETTY_FUNCTION__ << ": only one server per address allowed, address = " << aServer->getAddress().asString();
 			throw std::runtime_error( os.str());
 		}
 
-		servers.insert(std::make_pair(aServer->getPort(),aServer));
+		servers.insert(std::make_pair(serverKey(aServer->getAddress()),aServer));
 
 		if(start)
 		{
@@ -41,23 +78,30 @@ namespace Messaging
 	 */
 	void CommunicationService::startServer(	ServerPtr aServer)
 	{
-		startServer(aServer->getPort());
+		startServer(aServer->getAddress());
 	}
 
 	/**
 	 *
 	 */
 	void CommunicationService::startServer(	unsigned short aPort)
+	{
+		startServer(Address("", aPort));
+	}
+	/**
+	 *
+	 */
+	void CommunicationService::startServer(	const Address& anAddress)
 	{
 		// TODO See above
-		auto result = servers.find(aPort);
+		auto result = servers.find(serverKey(anAddress));
 		if(result != servers.end())
 		{
 			result->second->startHandlingRequests();
 		}else
 		{
 			std::ostringstream os;
-			os << __PRETTY_FUNCTION__ << ": no server registered for port " << aPort;
+			os << __PRETTY_FUNCTION__ << ": no server registered for address " << anAddress.asString();
 			throw std::runtime_error( os.str());
 		}
 	}
@@ -67,16 +111,24 @@ namespace Messaging
 	void CommunicationService::stopServer(ServerPtr aServer,
 										  bool deregister /* = true */)
 	{
-		stopServer(aServer->getPort(), deregister);
+		stopServer(aServer->getAddress(), deregister);
 	}
 	/**
 	 *
 	 */
 	void CommunicationService::stopServer(	unsigned short aPort,
 											bool deregister /* = true */)
+	{
+		stopServer(Address("", aPort), deregister);
+	}
+	/**
+	 *
+	 */
+	void CommunicationService::stopServer(	const Address& anAddress,
+											bool deregister /* = true */)
 	{
 		// TODO See above
-		auto result = servers.find(aPort);
+		auto result = servers.find(serverKey(anAddress));
 		if(result != servers.end())
 		{
 			ServerPtr server = result->second;
@@ -91,7 +143,7 @@ namespace Messaging
 			{
 				// The number of seconds needs to be larger than the number of seconds it takes
 				// the server to stop handling requests (which is 1 second now)??
-				timer.expires_from_now(boost::posix_time::seconds(2));
+				timer.expires_after(Base::Clock::getClock().getTimerDelay(std::chrono::seconds(2)));
 				timer.async_wait( [ this]( const boost::system::error_code&UNUSEDPARAM(e)) // @suppress("Method cannot be resolved")
 				{
 					boost::asio::defer( [this]() // @suppress("Invalid arguments")
@@ -104,7 +156,7 @@ namespace Messaging
 		}else
 		{
 			std::ostringstream os;
-			os << __PRETTY_FUNCTION__ << ": no server registered for port " << aPort;
+			os << __PRETTY_FUNCTION__ << ": no server registered for address " << anAddress.asString();
 			throw std::runtime_error( os.str());
 		}
 	}
@@ -113,25 +165,112 @@ namespace Messaging
 	 */
 	void CommunicationService::deregisterServer(ServerPtr aServer)
 	{
-		deregisterServer(aServer->getPort());
+		deregisterServer(aServer->getAddress());
 	}
 	/**
 	 *
 	 */
 	void CommunicationService::deregisterServer(unsigned short aPort)
+	{
+		deregisterServer(Address("", aPort));
+	}
+	/**
+	 *
+	 */
+	void CommunicationService::deregisterServer(const Address& anAddress)
 	{
 		// TODO See above
-		auto result = servers.find(aPort);
+		auto result = servers.find(serverKey(anAddress));
 		if(result != servers.end())
 		{
-			servers.erase(result->second->getPort());
+			servers.erase(result);
 		}else
 		{
 			std::ostringstream os;
-			os << __PRETTY_FUNCTION__ << ": no server registered for port " << aPort;
+			os << __PRETTY_FUNCTION__ << ": no server registered for address " << anAddress.asString();
 			throw std::runtime_error( os.str());
 		}
 	}
+	/**
+	 *
+	 */
+	/* static */std::string CommunicationService::serverKey( const Address& anAddress)
+	{
+		return anAddress.isLocal() ? anAddress.asString() : Address( "", anAddress.port).asString();
+	}
+	/**
+	 *
+	 */
+	ConnectionPtr CommunicationService::getConnection(const std::string& aHostName,
+													  unsigned short aPort)
+	{
+		return getConnection(Address(aHostName, aPort));
+	}
+	/**
+	 *
+	 */
+	ConnectionPtr CommunicationService::getConnection(const Address& anAddress)
+	{
+		std::string key = anAddress.asString();
+
+		std::lock_guard< std::mutex > lock(connectionsBusy);
+		auto result = connections.find(key);
+		if(result != connections.end())
+		{
+			return result->second;
+		}
+		ConnectionPtr connection = std::make_shared<Connection>(anAddress);
+		connections.insert(std::make_pair(key, connection));
+		return connection;
+	}
+	/**
+	 *
+	 */
+	TelemetrySenderPtr CommunicationService::getTelemetrySender(const std::string& aHostName,
+																unsigned short aPort)
+	{
+		std::string key = aHostName + ":" + std::to_string(aPort);
+
+		std::lock_guard< std::mutex > lock(telemetryBusy);
+		auto result = telemetrySenders.find(key);
+		if(result != telemetrySenders.end())
+		{
+			return result->second;
+		}
+		TelemetrySenderPtr sender = std::make_shared<TelemetrySender>(aHostName, aPort);
+		telemetrySenders.insert(std::make_pair(key, sender));
+		return sender;
+	}
+	/**
+	 *
+	 */
+	void CommunicationService::startTelemetryReceiver(	unsigned short aPort,
+														ResponseHandlerPtr aResponseHandler)
+	{
+		std::lock_guard< std::mutex > lock(telemetryBusy);
+		if(telemetryReceivers.find(aPort) != telemetryReceivers.end())
+		{
+			std::ostringstream os;
+			os << __PRETTY_FUNCTION__ << ": only one telemetry receiver per port allowed, port = " << aPort;
+			throw std::runtime_error( os.str());
+		}
+		TelemetryReceiverPtr receiver = std::make_shared<TelemetryReceiver>(aPort, aResponseHandler);
+		receiver->start();
+		telemetryReceivers.insert(std::make_pair(aPort, receiver));
+	}
+	/**
+	 *
+	 */
+	void CommunicationService::stopTelemetryReceiver(unsigned short aPort)
+	{
+		std::lock_guard< std::mutex > lock(telemetryBusy);
+		auto result = telemetryReceivers.find(aPort);
+		if(result != telemetryReceivers.end())
+		{
+			result->second->stop();
+			telemetryReceivers.erase(result);
+		}
+	}
 	/**
 	 *
 	 */
@@ -151,36 +290,49 @@ namespace Messaging
 	 */
 	void CommunicationService::restart()
 	{
-		if(io_contextThread.joinable())
+		for (std::thread& io_contextThread : io_contextThreads)
 		{
-			io_contextThread.detach();
+			if(io_contextThread.joinable())
+			{
+				io_contextThread.detach();
+			}
 		}
-		start_io_context_thread();
+		start_io_context_threads();
 	}
 	/**
 	 *
 	 */
 	void CommunicationService::wait()
 	{
-		io_contextThread.join();
+		for (std::thread& io_contextThread : io_contextThreads)
+		{
+			if(io_contextThread.joinable())
+			{
+				io_contextThread.join();
+			}
+		}
 	}
 
 	/**
 	 *
 	 */
-	CommunicationService::CommunicationService() : 	timer( io_context)
+	CommunicationService::CommunicationService() : 	io_context( static_cast< int >( getNumberOfThreads())),
+													timer( io_context)
 
 	{
-		start_io_context_thread();
+		start_io_context_threads();
 	}
 	/**
 	 *
 	 */
 	CommunicationService::~CommunicationService()
 	{
-		if(io_contextThread.joinable())
+		for (std::thread& io_contextThread : io_contextThreads)
 		{
-			io_contextThread.detach();
+			if(io_contextThread.joinable())
+			{
+				io_contextThread.detach();
+			}
 		}
 	}
 	/**
@@ -189,10 +341,20 @@ namespace Messaging
 	/**
 	 *
 	 */
-	void CommunicationService::start_io_context_thread()
+	void CommunicationService::start_io_context_threads()
 	{
-		std::thread new_io_contextThread([this]{run_io_context();});
-		io_contextThread.swap(new_io_contextThread);
+		// Restart here and not in the threads, a thread that restarts while the others already run would be a race
+		if(io_context.stopped())
+		{
+			io_context.restart();
+		}
+
+		std::vector< std::thread > new_io_contextThreads;
+		for (std::size_t i = 0; i < getNumberOfThreads(); ++i)
+		{
+			new_io_contextThreads.emplace_back([this]{run_io_context();});
+		}
+		io_contextThreads.swap(new_io_contextThreads);
 		//io_contextThread.detach();
 	}
 	/**
@@ -200,10 +362,6 @@ namespace Messaging
 	 */
 	void CommunicationService::run_io_context()
 	{
-		if(io_context.stopped())
-		{
-			io_context.restart();
-		}
 
 		// @see https://www.boost.org/doc/libs/1_76_0/doc/html/boost_asio/reference/io_context.html
 		// for the loop and the work...
@@ -3,21 +3,40 @@
 
 #include "Config.hpp"
 
+#include "Address.hpp"
 #include "Trace.hpp"
 
 #include <boost/asio.hpp>
 
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <map>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace Messaging
 {
 	class Server;
 	typedef std::shared_ptr< Server > ServerPtr;
+	class Connection;
+	typedef std::shared_ptr< Connection > ConnectionPtr;
+	class TelemetrySender;
+	typedef std::shared_ptr< TelemetrySender > TelemetrySenderPtr;
+	class TelemetryReceiver;
+	typedef std::shared_ptr< TelemetryReceiver > TelemetryReceiverPtr;
+	class ResponseHandler;
+	typedef std::shared_ptr< ResponseHandler > ResponseHandlerPtr;
 
 	/*
+	 * Runs the io_context on a pool of threads, by default one per core.
 	 *
+	 * Every Session gets its own strand as the executor of its socket, so the handlers of one
+	 * connection never run concurrently while different connections are served in parallel.
+	 * Request and response handlers run on the Base::ThreadPool, not on the io threads, so a
+	 * slow handler does not hold up the network.
 	 */
 	class CommunicationService
 	{
@@ -26,6 +45,24 @@ namespace Messaging
 			 *
 			 */
 			static CommunicationService& getCommunicationService();
+			/**
+			 * Sets the number of threads that run the io_context, 0 for one per core. Only has effect
+			 * if called before the first call of getCommunicationService().
+			 */
+			static void setNumberOfThreads( std::size_t aNumberOfThreads);
+			/**
+			 *
+			 */
+			static std::size_t getNumberOfThreads();
+			/**
+			 * By default a Connection to a server on the same host moves to a SharedMemoryChannel
+			 * once it is connected, false keeps all traffic on the socket
+			 */
+			static void setSharedMemoryEnabled( bool anEnabled);
+			/**
+			 *
+			 */
+			static bool isSharedMemoryEnabled();
 			/**
 			 * This function is public because otherwise it the classes Session, Server and Client
 			 * have to be friends
@@ -47,6 +84,10 @@ namespace Messaging
 			 *
 			 */
 			void startServer(	unsigned short aPort);
+			/**
+			 *
+			 */
+			void startServer(	const Address& anAddress);
 			/**
 			 *
 			 */
@@ -60,11 +101,43 @@ namespace Messaging
 			/**
 			 *
 			 */
+			void stopServer(const Address& anAddress,
+							bool deregister = true);
+			/**
+			 *
+			 */
 			void deregisterServer(	ServerPtr aServer);
 			/**
 			 *
 			 */
 			void deregisterServer(	unsigned short aPort);
+			/**
+			 *
+			 */
+			void deregisterServer(	const Address& anAddress);
+			/**
+			 * Returns the persistent connection to aHostName:aPort, which is created on first use
+			 */
+			ConnectionPtr getConnection(const std::string& aHostName,
+										unsigned short aPort);
+			/**
+			 * Returns the persistent connection to anAddress, which is created on first use
+			 */
+			ConnectionPtr getConnection(const Address& anAddress);
+			/**
+			 * Returns the UDP telemetry sender to aHostName:aPort, which is created on first use
+			 */
+			TelemetrySenderPtr getTelemetrySender(	const std::string& aHostName,
+													unsigned short aPort);
+			/**
+			 * Starts receiving telemetry on UDP port aPort, the messages are handed to aResponseHandler
+			 */
+			void startTelemetryReceiver(unsigned short aPort,
+										ResponseHandlerPtr aResponseHandler);
+			/**
+			 *
+			 */
+			void stopTelemetryReceiver(unsigned short aPort);
 			/**
 			 *
 			 */
@@ -92,29 +165,55 @@ namespace Messaging
 			 */
 			~CommunicationService();
 			/**
-			 *
+			 * Starts numberOfThreads threads that run the io_context
 			 */
-			void start_io_context_thread();
+			void start_io_context_threads();
 			/**
 			 *
 			 */
 			void run_io_context();
 			/**
+			 * A TCP server listens on every interface, so only the port of a TCP address
+			 * identifies it: "localhost:12345" and ":12345" are the same server.
 			 *
+			 * @return The key of anAddress in servers
 			 */
-			boost::asio::io_context io_context;
+			static std::string serverKey( const Address& anAddress);
 			/**
 			 *
 			 */
-			std::thread io_contextThread;
+			static std::atomic< std::size_t > numberOfThreads;
 			/**
 			 *
 			 */
-			std::map<unsigned short, ServerPtr > servers;
+			static std::atomic< bool > sharedMemoryEnabled;
+			/**
+			 *
+			 */
+			boost::asio::io_context io_context;
+			/**
+			 *
+			 */
+			std::vector< std::thread > io_contextThreads;
+			/**
+			 * By serverKey()
+			 */
+			std::map<std::string, ServerPtr > servers;
+			/**
+			 * By Address::asString()
+			 */
+			std::map<std::string, ConnectionPtr > connections;
+			std::mutex connectionsBusy;
+			/**
+			 * Senders by "host:port", receivers by port
+			 */
+			std::map<std::string, TelemetrySenderPtr > telemetrySenders;
+			std::map<unsigned short, TelemetryReceiverPtr > telemetryReceivers;
+			std::mutex telemetryBusy;
 			/**
 			 *
 			 */
-			boost::asio::deadline_timer timer;
+			boost::asio::steady_timer timer;
 
 
 	};
@@ -0,0 +1,423 @@
+#include "Connection.hpp"
+
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+#include <sstream>
+#include <thread>
+
+namespace Messaging
+{
+	/**
+	 *
+	 */
+	Connection::Connection(	const Address& anAddress) :
+								address( anAddress),
+								resolver( socket.get_executor()),
+								endpointResolved( false),
+								sameHost( false),
+								nextCorrelationId( 1),
+								connecting( false),
+								offering( false),
+								writing( false),
+								reading( false),
+								failed( false),
+								used( false),
+								sharedMemoryRefused( false)
+	{
+	}
+	/**
+	 *
+	 */
+	void Connection::dispatchMessage(	const Message& aMessage,
+										ResponseHandlerPtr aResponseHandler)
+	{
+		ConnectionPtr self = shared_from_this();
+		boost::asio::post(	socket.get_executor(), // @suppress("Invalid arguments")
+							[self, aMessage, aResponseHandler]()
+							{
+								Request request{ aMessage, aResponseHandler, false, false};
+								request.message.setCorrelationId( self->nextCorrelationId++);
+								self->unwrittenRequests.push_back( request);
+								self->sendNextRequest();
+							});
+	}
+	/**
+	 *
+	 */
+	void Connection::close()
+	{
+		boost::system::error_code error;
+		socket.shutdown( boost::asio::socket_base::shutdown_both, error);
+		socket.close( error);
+		used = false;
+		if (channel)
+		{
+			// Also ends the thread that reads the channel and the session of the server
+			channel->close();
+			channel.reset();
+		}
+		offering = false;
+	}
+	/**
+	 *
+	 */
+	void Connection::start()
+	{
+		if (channel)
+		{
+			writeToChannel();
+			return;
+		}
+
+		Request request = unwrittenRequests.front();
+		unwrittenRequests.pop_front();
+		request.reused = used;
+		outstandingRequests.insert( std::make_pair( request.message.getCorrelationId(), request));
+
+		writing = true;
+		writeMessage( request.message);
+
+		// The responses are read while the next requests are written
+		if (!reading)
+		{
+			reading = true;
+			readMessage();
+		}
+	}
+	/**
+	 *
+	 */
+	void Connection::handleMessageRead()
+	{
+		reading = false;
+		if (message.getMessageType() == CommunicationReadError)
+		{
+			handleFailure( message.getBody());
+			return;
+		}
+		if (failed)
+		{
+			recover();
+			return;
+		}
+		if (offering && message.getCorrelationId() == 0)
+		{
+			handleSharedMemoryResponse();
+			return;
+		}
+
+		handleResponse( message);
+
+		// Once on a channel the socket is read as long as it is open, that is how a server that is gone is noticed
+		if ((channel || !outstandingRequests.empty()) && !reading)
+		{
+			reading = true;
+			readMessage();
+		}
+		sendNextRequest();
+	}
+	/**
+	 *
+	 */
+	void Connection::handleResponse( const Message& aResponse)
+	{
+		used = true;
+
+		auto result = outstandingRequests.find( aResponse.getCorrelationId());
+		if (result != outstandingRequests.end())
+		{
+			ResponseHandlerPtr responseHandler = result->second.responseHandler;
+			if (aResponse.isStream())
+			{
+				// More responses follow, the subscription is kept. It carried a response so it is
+				// worth subscribing again once if the connection breaks later on.
+				result->second.reused = true;
+				result->second.retried = false;
+			} else
+			{
+				outstandingRequests.erase( result);
+			}
+			// This is the place where any reply message from the server should be handled,
+			// on the ThreadPool so a slow handler does not hold up the io threads
+			Base::ThreadPool::getThreadPool().submit( [responseHandler, aResponse]()
+			{
+				responseHandler->handleResponse( aResponse);
+			});
+		} else
+		{
+			TRACE_DEVELOP( "*** Connection::handleResponse: no request for response " + aResponse.asString());
+		}
+	}
+	/**
+	 *
+	 */
+	void Connection::handleMessageWritten()
+	{
+		writing = false;
+		if (outgoingMessage.getMessageType() == CommunicationWriteError)
+		{
+			handleFailure( outgoingMessage.getBody());
+			return;
+		}
+		if (failed)
+		{
+			recover();
+			return;
+		}
+		sendNextRequest();
+	}
+	/**
+	 *
+	 */
+	void Connection::sendNextRequest()
+	{
+		if (failed || connecting || offering || writing || unwrittenRequests.empty())
+		{
+			return;
+		}
+		if (socket.is_open())
+		{
+			start();
+			return;
+		}
+
+		if (!endpointResolved && address.isLocal())
+		{
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+			endpoint = boost::asio::local::stream_protocol::endpoint( address.socketPath);
+			endpointResolved = true;
+			sameHost = true;
+#else
+			for (const Request& request : unwrittenRequests)
+			{
+				dropRequest( request, "no Unix domain sockets on this platform");
+			}
+			unwrittenRequests.clear();
+			return;
+#endif
+		} else if (!endpointResolved)
+		{
+			// A slow name server must not hold up the io thread, and with it the other connections
+			connecting = true;
+			ConnectionPtr self = shared_from_this();
+			resolver.async_resolve(	boost::asio::ip::tcp::v4(), // @suppress("Method cannot be resolved") // @suppress("Invalid arguments")
+									address.host,
+									std::to_string( address.port),
+									[self](	const boost::system::error_code& error,
+											const boost::asio::ip::tcp::resolver::results_type& results)
+									{
+										self->handleResolve( error, results);
+									});
+			return;
+		}
+
+		connecting = true;
+		ConnectionPtr self = shared_from_this();
+		socket.async_connect(	endpoint, // @suppress("Method cannot be resolved") // @suppress("Invalid arguments")
+								[self](const boost::system::error_code& error)
+								{
+									self->handleConnect( error);
+								});
+	}
+	/**
+	 *
+	 */
+	void Connection::handleResolve(	const boost::system::error_code& anError,
+									const boost::asio::ip::tcp::resolver::results_type& aResults)
+	{
+		connecting = false;
+		if (anError || aResults.empty())
+		{
+			std::string reason = "cannot resolve " + address.host + ": " + anError.message();
+			for (const Request& request : unwrittenRequests)
+			{
+				dropRequest( request, reason);
+			}
+			unwrittenRequests.clear();
+			return;
+		}
+		endpoint = aResults.begin()->endpoint();
+		endpointResolved = true;
+		sameHost = aResults.begin()->endpoint().address().is_loopback();
+		sendNextRequest();
+	}
+	/**
+	 *
+	 */
+	void Connection::handleConnect( const boost::system::error_code& anError)
+	{
+		connecting = false;
+		if (anError)
+		{
+			// The address may have changed, resolve again on the next attempt
+			endpointResolved = false;
+			close();
+			for (const Request& request : unwrittenRequests)
+			{
+				dropRequest( request, "error connecting: " + anError.message());
+			}
+			unwrittenRequests.clear();
+			return;
+		}
+		if (!address.isLocal())
+		{
+			boost::system::error_code error;
+			socket.set_option( boost::asio::ip::tcp::no_delay( true), error);
+		}
+		resetReceiveBuffer();
+		used = false;
+
+		if (CommunicationService::isSharedMemoryEnabled() && !sharedMemoryRefused && sameHost)
+		{
+			offerSharedMemory();
+			return;
+		}
+		sendNextRequest();
+	}
+	/**
+	 *
+	 */
+	void Connection::offerSharedMemory()
+	{
+		channel = SharedMemoryChannel::create();
+		if (!channel)
+		{
+			sharedMemoryRefused = true;
+			sendNextRequest();
+			return;
+		}
+
+		// Correlation id 0 is never used by a request
+		offering = true;
+		writing = true;
+		writeMessage( Message( SharedMemoryRequest, channel->getName()));
+		reading = true;
+		readMessage();
+	}
+	/**
+	 *
+	 */
+	void Connection::handleSharedMemoryResponse()
+	{
+		offering = false;
+		// Either the server has it mapped by now or it never will
+		channel->unlink();
+		if (message.getMessageType() == SharedMemoryResponse && message.getBody().empty())
+		{
+			TRACE_DEVELOP( "Connection to " + address.asString() + " uses " + channel->getName());
+			std::thread thread( &Connection::readFromChannel, shared_from_this(), channel);
+			thread.detach();
+		} else
+		{
+			channel->close();
+			channel.reset();
+			sharedMemoryRefused = true;
+		}
+
+		if (channel && !reading)
+		{
+			reading = true;
+			readMessage();
+		}
+		sendNextRequest();
+	}
+	/**
+	 *
+	 */
+	void Connection::writeToChannel()
+	{
+		while (!unwrittenRequests.empty())
+		{
+			// Never wait on the strand, a full channel is written to again when the next response comes in
+			if (!channel->tryWriteMessage( unwrittenRequests.front().message))
+			{
+				if (channel->isClosed())
+				{
+					handleFailure( "shared memory channel closed");
+				}
+				return;
+			}
+			Request request = unwrittenRequests.front();
+			unwrittenRequests.pop_front();
+			request.reused = used;
+			outstandingRequests.insert( std::make_pair( request.message.getCorrelationId(), request));
+		}
+	}
+	/**
+	 *
+	 */
+	/* static */void Connection::readFromChannel(	ConnectionPtr aConnection,
+													SharedMemoryChannelPtr aChannel)
+	{
+		Message response;
+		while (aChannel->readMessage( response))
+		{
+			boost::asio::post(	aConnection->socket.get_executor(), // @suppress("Invalid arguments")
+								[aConnection, aChannel, response]()
+								{
+									// A response of a channel that is closed in the mean time belongs to requests that are already retried
+									if (aConnection->channel == aChannel)
+									{
+										aConnection->handleResponse( response);
+										aConnection->sendNextRequest();
+									}
+								});
+		}
+	}
+	/**
+	 *
+	 */
+	void Connection::handleFailure( const std::string& aReason)
+	{
+		if (!failed)
+		{
+			failed = true;
+			failure = aReason;
+			// Cancels the other pending read or write, its handler ends up in recover() as well
+			close();
+		}
+		recover();
+	}
+	/**
+	 *
+	 */
+	void Connection::recover()
+	{
+		if (writing || reading || connecting)
+		{
+			return;
+		}
+		failed = false;
+
+		// A connection that was idle may have been closed by the server in the mean time, that is no
+		// reason to give up on the requests. The map is ordered by id so the original order is kept.
+		std::deque< Request > retries;
+		for (const auto& outstandingRequest : outstandingRequests)
+		{
+			Request request = outstandingRequest.second;
+			if (request.reused && !request.retried)
+			{
+				request.retried = true;
+				retries.push_back( request);
+			} else
+			{
+				dropRequest( request, failure);
+			}
+		}
+		outstandingRequests.clear();
+		unwrittenRequests.insert( unwrittenRequests.begin(), retries.begin(), retries.end());
+
+		sendNextRequest();
+	}
+	/**
+	 *
+	 */
+	void Connection::dropRequest(	const Request& aRequest,
+									const std::string& aReason)
+	{
+		std::ostringstream os;
+		os << __PRETTY_FUNCTION__ << ": dropping request to " << address.asString() << ", reason: " << aReason << ", request: " << aRequest.message.asString();
+		TRACE_DEVELOP( os.str());
+	}
+} // namespace Messaging
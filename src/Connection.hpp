@@ -0,0 +1,200 @@
+#ifndef CONNECTION_HPP_
+#define CONNECTION_HPP_
+
+#include "Config.hpp"
+
+#include "Address.hpp"
+#include "Session.hpp"
+#include "SharedMemoryChannel.hpp"
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace Messaging
+{
+	/**
+	 * A persistent connection to one remote server, shared by all Clients of that server. The
+	 * server is either on a TCP port or on a Unix domain socket, see Address.
+	 *
+	 * Every request gets a correlation id and is written as soon as the previous write is done,
+	 * without waiting for the responses to earlier requests, so many requests can be in flight at
+	 * once. The server copies the id into the response and the response is handed to the
+	 * ResponseHandler of the request with that id, in whatever order the responses arrive.
+	 *
+	 * A request with the Message::Stream flag is a subscription: it stays outstanding as long as the
+	 * responses have the Stream flag too, and the connection keeps reading for them.
+	 *
+	 * The connection stays open, the resolved endpoint is cached. If the server closed a
+	 * connection that was used before, e.g. because the server was restarted, the requests that
+	 * were in flight are sent again on a new connection. A request that fails on a fresh connection
+	 * is dropped.
+	 *
+	 * If the server is on the same host, i.e. on a Unix domain socket or a loopback address, the
+	 * connection offers it a SharedMemoryChannel as soon as it is connected. If the server accepts,
+	 * the requests and responses go through the channel and the socket only stays open to notice
+	 * that the server is gone. A server that does not know the offer answers it with something else
+	 * and the connection stays on the socket.
+	 *
+	 * All members but dispatchMessage() are only used on the strand of the socket.
+	 */
+	class Connection :	public Session,
+						public std::enable_shared_from_this< Connection >
+	{
+		public:
+			/**
+			 *
+			 */
+			explicit Connection( const Address& anAddress);
+			/**
+			 *
+			 */
+			virtual ~Connection() = default;
+			/**
+			 * May be called from any thread, the response is handed to aResponseHandler on the
+			 * Base::ThreadPool
+			 */
+			void dispatchMessage(	const Message& aMessage,
+									ResponseHandlerPtr aResponseHandler);
+			/**
+			 * Closes the socket, the next request reconnects
+			 */
+			void close();
+			/**
+			 * @see Session::start()
+			 */
+			virtual void start() override;
+			/**
+			 * @see Session::handleMessageRead()
+			 */
+			virtual void handleMessageRead() override;
+			/**
+			 * @see Session::handleMessageWritten()
+			 */
+			virtual void handleMessageWritten() override;
+
+		private:
+			/**
+			 *
+			 */
+			struct Request
+			{
+					Message message;
+					ResponseHandlerPtr responseHandler;
+					/**
+					 * True if the request went over a connection that already carried a response
+					 */
+					bool reused;
+					/**
+					 * True if the request is sent again after a failure
+					 */
+					bool retried;
+			};
+			/**
+			 * Connects if needed and starts writing the oldest unwritten request
+			 */
+			void sendNextRequest();
+			/**
+			 * Called on the strand when the host name of address is resolved, connects if it was
+			 */
+			void handleResolve(	const boost::system::error_code& anError,
+								const boost::asio::ip::tcp::resolver::results_type& aResults);
+			/**
+			 *
+			 */
+			void handleConnect( const boost::system::error_code& anError);
+			/**
+			 * Offers the server a SharedMemoryChannel, the requests wait for the answer
+			 */
+			void offerSharedMemory();
+			/**
+			 *
+			 */
+			void handleSharedMemoryResponse();
+			/**
+			 * Queues the unwritten requests on the channel as long as it has room for them
+			 */
+			void writeToChannel();
+			/**
+			 * Hands the responses from aChannel to the strand until the channel is closed, runs on a thread of its own
+			 */
+			static void readFromChannel(	ConnectionPtr aConnection,
+											SharedMemoryChannelPtr aChannel);
+			/**
+			 * Hands aResponse to the ResponseHandler of its request
+			 */
+			void handleResponse( const Message& aResponse);
+			/**
+			 * Closes the socket. As soon as no read or write is pending anymore the requests in flight are
+			 * either queued again or dropped.
+			 */
+			void handleFailure( const std::string& aReason);
+			/**
+			 *
+			 */
+			void recover();
+			/**
+			 *
+			 */
+			void dropRequest(	const Request& aRequest,
+								const std::string& aReason);
+			/**
+			 *
+			 */
+			Address address;
+			/**
+			 * Runs on the strand of the socket
+			 */
+			boost::asio::ip::tcp::resolver resolver;
+			/**
+			 * Resolved on the first connect and kept until a connect fails
+			 */
+			boost::asio::generic::stream_protocol::endpoint endpoint;
+			bool endpointResolved;
+			/**
+			 * True if the endpoint is a Unix domain socket or a loopback address
+			 */
+			bool sameHost;
+			/**
+			 * Requests that are not written yet, oldest first
+			 */
+			std::deque< Request > unwrittenRequests;
+			/**
+			 * Requests that are written, or being written, and wait for their response, by correlation id
+			 */
+			std::map< unsigned long, Request > outstandingRequests;
+			/**
+			 *
+			 */
+			unsigned long nextCorrelationId;
+			/**
+			 *
+			 */
+			bool connecting;
+			bool offering;
+			bool writing;
+			bool reading;
+			/**
+			 * Set when the socket failed, until all pending reads and writes are finished
+			 */
+			bool failed;
+			std::string failure;
+			/**
+			 * True if the socket carried a response since it was connected
+			 */
+			bool used;
+			/**
+			 * The channel that is offered or in use, nullptr if the requests go over the socket
+			 */
+			SharedMemoryChannelPtr channel;
+			/**
+			 * Set when the server refused a channel, it is not offered again
+			 */
+			bool sharedMemoryRefused;
+	};
+	// class Connection
+	typedef std::shared_ptr< Connection > ConnectionPtr;
+} // namespace Messaging
+
+#endif // CONNECTION_HPP_
@@ -0,0 +1,308 @@
+#ifndef LOCKFREEQUEUE_HPP_
+#define LOCKFREEQUEUE_HPP_
+
+#include "Config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace Base
+{
+	/**
+	 * Used to keep the indexes of producers and consumers on separate cache lines
+	 */
+	constexpr std::size_t CacheLineSize = 64;
+	/**
+	 *
+	 */
+	inline std::size_t roundUpToPowerOfTwo( std::size_t aValue)
+	{
+		std::size_t result = 1;
+		while (result < aValue)
+		{
+			result <<= 1;
+		}
+		return result;
+	}
+
+	/**
+	 * A bounded ring buffer for exactly one producer thread and one consumer thread.
+	 *
+	 * Both sides only touch their own index and a cached copy of the other side's index, so
+	 * in the common case an operation is a couple of loads and one release store.
+	 */
+	template< typename T >
+	class SpscQueue
+	{
+		public:
+			/**
+			 * The capacity is rounded up to a power of 2
+			 */
+			explicit SpscQueue( std::size_t aCapacity) :
+						capacity( roundUpToPowerOfTwo( aCapacity)),
+						mask( capacity - 1),
+						slots( new T[capacity]),
+						head( 0),
+						tail( 0),
+						cachedHead( 0),
+						cachedTail( 0)
+			{
+			}
+			/**
+			 *
+			 */
+			SpscQueue( const SpscQueue& aQueue) = delete;
+			/**
+			 *
+			 */
+			SpscQueue& operator=( const SpscQueue& aQueue) = delete;
+			/**
+			 * Producer side
+			 *
+			 * @return false if the queue is full
+			 */
+			template< typename U >
+			bool tryEnqueue( U&& anElement)
+			{
+				const std::size_t currentTail = tail.load( std::memory_order_relaxed);
+				if (currentTail - cachedHead == capacity)
+				{
+					cachedHead = head.load( std::memory_order_acquire);
+					if (currentTail - cachedHead == capacity)
+					{
+						return false;
+					}
+				}
+				slots[currentTail & mask] = std::forward< U >( anElement);
+				tail.store( currentTail + 1, std::memory_order_release);
+				return true;
+			}
+			/**
+			 * Consumer side
+			 *
+			 * @return false if the queue is empty
+			 */
+			bool tryDequeue( T& anElement)
+			{
+				return tryDequeue( &anElement, 1) == 1;
+			}
+			/**
+			 * Consumer side, moves up to aMaxCount elements into aBuffer at the cost of a single
+			 * index update
+			 *
+			 * @return the number of elements dequeued
+			 */
+			std::size_t tryDequeue(	T* aBuffer,
+									std::size_t aMaxCount)
+			{
+				const std::size_t currentHead = head.load( std::memory_order_relaxed);
+				if (cachedTail - currentHead < aMaxCount)
+				{
+					cachedTail = tail.load( std::memory_order_acquire);
+				}
+				std::size_t count = cachedTail - currentHead;
+				if (count > aMaxCount)
+				{
+					count = aMaxCount;
+				}
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					aBuffer[i] = std::move( slots[(currentHead + i) & mask]);
+				}
+				if (count > 0)
+				{
+					head.store( currentHead + count, std::memory_order_release);
+				}
+				return count;
+			}
+			/**
+			 * Only exact if neither side is busy
+			 */
+			std::size_t sizeApprox() const
+			{
+				return tail.load( std::memory_order_acquire) - head.load( std::memory_order_acquire);
+			}
+			/**
+			 *
+			 */
+			std::size_t getCapacity() const
+			{
+				return capacity;
+			}
+
+		private:
+			const std::size_t capacity;
+			const std::size_t mask;
+			std::unique_ptr< T[] > slots;
+			/**
+			 * Written by the consumer
+			 */
+			alignas(CacheLineSize) std::atomic< std::size_t > head;
+			/**
+			 * Written by the producer
+			 */
+			alignas(CacheLineSize) std::atomic< std::size_t > tail;
+			/**
+			 * The producer's copy of head
+			 */
+			alignas(CacheLineSize) std::size_t cachedHead;
+			/**
+			 * The consumer's copy of tail
+			 */
+			alignas(CacheLineSize) std::size_t cachedTail;
+	};
+	// class SpscQueue
+
+	/**
+	 * A bounded ring buffer for any number of producer and consumer threads.
+	 *
+	 * Every slot carries a sequence number that tells whether it is free for the producer or full for
+	 * the consumer with a given position, so producers and consumers only contend on their own
+	 * position counter and never take a lock.
+	 */
+	template< typename T >
+	class MpmcQueue
+	{
+		public:
+			/**
+			 * The capacity is rounded up to a power of 2
+			 */
+			explicit MpmcQueue( std::size_t aCapacity) :
+						capacity( roundUpToPowerOfTwo( aCapacity)),
+						mask( capacity - 1),
+						slots( new Slot[capacity]),
+						enqueuePosition( 0),
+						dequeuePosition( 0)
+			{
+				for (std::size_t i = 0; i < capacity; ++i)
+				{
+					slots[i].sequence.store( i, std::memory_order_relaxed);
+				}
+			}
+			/**
+			 *
+			 */
+			MpmcQueue( const MpmcQueue& aQueue) = delete;
+			/**
+			 *
+			 */
+			MpmcQueue& operator=( const MpmcQueue& aQueue) = delete;
+			/**
+			 * @return false if the queue is full
+			 */
+			template< typename U >
+			bool tryEnqueue( U&& anElement)
+			{
+				std::size_t position = enqueuePosition.load( std::memory_order_relaxed);
+				for (;;)
+				{
+					Slot& slot = slots[position & mask];
+					const std::size_t sequence = slot.sequence.load( std::memory_order_acquire);
+					const std::ptrdiff_t difference = static_cast< std::ptrdiff_t >(sequence - position);
+					if (difference == 0)
+					{
+						if (enqueuePosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed))
+						{
+							slot.element = std::forward< U >( anElement);
+							slot.sequence.store( position + 1, std::memory_order_release);
+							return true;
+						}
+					} else if (difference < 0)
+					{
+						return false;
+					} else
+					{
+						position = enqueuePosition.load( std::memory_order_relaxed);
+					}
+				}
+			}
+			/**
+			 * @return false if the queue is empty
+			 */
+			bool tryDequeue( T& anElement)
+			{
+				return tryDequeue( &anElement, 1) == 1;
+			}
+			/**
+			 * Moves up to aMaxCount elements into aBuffer. The run of full slots is claimed with a single
+			 * update of the dequeue position, so a batch costs one contended operation instead of one per element.
+			 *
+			 * @return the number of elements dequeued
+			 */
+			std::size_t tryDequeue(	T* aBuffer,
+									std::size_t aMaxCount)
+			{
+				std::size_t position = dequeuePosition.load( std::memory_order_relaxed);
+				for (;;)
+				{
+					std::size_t count = 0;
+					while (count < aMaxCount)
+					{
+						const std::size_t sequence = slots[(position + count) & mask].sequence.load( std::memory_order_acquire);
+						if (sequence != position + count + 1)
+						{
+							break;
+						}
+						++count;
+					}
+					if (count == 0)
+					{
+						const std::size_t sequence = slots[position & mask].sequence.load( std::memory_order_acquire);
+						if (static_cast< std::ptrdiff_t >(sequence - (position + 1)) < 0)
+						{
+							return 0;
+						}
+						// Another consumer was faster
+						position = dequeuePosition.load( std::memory_order_relaxed);
+						continue;
+					}
+					if (dequeuePosition.compare_exchange_weak( position, position + count, std::memory_order_relaxed))
+					{
+						for (std::size_t i = 0; i < count; ++i)
+						{
+							Slot& slot = slots[(position + i) & mask];
+							aBuffer[i] = std::move( slot.element);
+							slot.sequence.store( position + i + capacity, std::memory_order_release);
+						}
+						return count;
+					}
+				}
+			}
+			/**
+			 * Only exact if nobody is enqueueing or dequeueing
+			 */
+			std::size_t sizeApprox() const
+			{
+				const std::size_t enqueued = enqueuePosition.load( std::memory_order_acquire);
+				const std::size_t dequeued = dequeuePosition.load( std::memory_order_acquire);
+				return enqueued > dequeued ? enqueued - dequeued : 0;
+			}
+			/**
+			 *
+			 */
+			std::size_t getCapacity() const
+			{
+				return capacity;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			struct Slot
+			{
+					std::atomic< std::size_t > sequence;
+					T element;
+			};
+
+			const std::size_t capacity;
+			const std::size_t mask;
+			std::unique_ptr< Slot[] > slots;
+			alignas(CacheLineSize) std::atomic< std::size_t > enqueuePosition;
+			alignas(CacheLineSize) std::atomic< std::size_t > dequeuePosition;
+	};
+	// class MpmcQueue
+} // namespace Base
+#endif // LOCKFREEQUEUE_HPP_
@@ -5,7 +5,7 @@
 
 namespace Application
 {
-	/* static */bool Logger::disable = false;
+	/* static */std::atomic< bool > Logger::disable( false);
 	/**
 	 *
 	 */
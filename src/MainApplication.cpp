@@ -1,5 +1,7 @@
 #include "MainApplication.hpp"
 
+#include "Clock.hpp"
+#include "CommunicationService.hpp"
 #include "MainFrameWindow.hpp"
 #include "ObjectId.hpp"
 
@@ -38,6 +40,27 @@ namespace Application
 
 		MainApplication::setCommandlineArguments( argc, argv);
 
+		// Run the simulation in virtual time, i.e. as fast as possible
+		if (MainApplication::isArgGiven("-virtual_time"))
+		{
+			Base::Clock::getClock().setMode( Base::Clock::VirtualTime);
+		}
+		// The maximum number of canvas updates per second, 0 updates on every change
+		if (MainApplication::isArgGiven("-frame_rate"))
+		{
+			settings.setFrameRate( std::stoul( MainApplication::getArg("-frame_rate").value));
+		}
+		// The number of threads that handle the network traffic, by default one per core
+		if (MainApplication::isArgGiven("-io_threads"))
+		{
+			Messaging::CommunicationService::setNumberOfThreads( std::stoul( MainApplication::getArg("-io_threads").value));
+		}
+		// Keep the traffic to a robot world on the same host on TCP instead of shared memory
+		if (MainApplication::isArgGiven("-no_shared_memory"))
+		{
+			Messaging::CommunicationService::setSharedMemoryEnabled( false);
+		}
+
 		MainFrameWindow* frame = nullptr;
 		if(MainApplication::isArgGiven("-worldname"))
 		{
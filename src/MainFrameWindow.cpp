@@ -701,18 +701,8 @@ void MainFrameWindow::OnSyncWorlds(wxCommandEvent&UNUSEDPARAM(anEvent)) {
 
 	std::ostringstream os;
 	os << __PRETTY_FUNCTION__ << " syncing worlds" << std::endl;
-    std::string remoteIpAdres = "localhost";
-		std::string remotePort = "12345";
-
-		if (MainApplication::isArgGiven("-remote_ip")) {
-			remoteIpAdres = MainApplication::getArg("-remote_ip").value;
-		}
-		if (MainApplication::isArgGiven("-remote_port")) {
-			remotePort = MainApplication::getArg("-remote_port").value;
-		}
-
 	Logger::log(os.str());
-    Messaging::Client client(remoteIpAdres, static_cast<unsigned short>(std::stoi(remotePort)), robot);
+    Messaging::Client client(Model::Robot::getRemoteAddress(), robot);
     client.dispatchMessage(Messaging::Message(Messaging::MergeRequest, "Syncing worlds"));
 }
 /**
@@ -735,23 +725,14 @@ void MainFrameWindow::OnSendMessage(wxCommandEvent&UNUSEDPARAM(anEvent)) {
 	Model::RobotPtr robot = Model::RobotWorld::getRobotWorld().getRobot(
 			"Butter");
 	if (robot) {
-		std::string remoteIpAdres = "localhost";
-		std::string remotePort = "12345";
-
-		if (MainApplication::isArgGiven("-remote_ip")) {
-			remoteIpAdres = MainApplication::getArg("-remote_ip").value;
-            // Logger::log("remote ip: " + remoteIpAdres + "\n");
-		}
-		if (MainApplication::isArgGiven("-remote_port")) {
-			remotePort = MainApplication::getArg("-remote_port").value;
-		}
+		const Messaging::Address remoteAddress =
+				Model::Robot::getRemoteAddress();
 
 		// We will request an echo message. The response will be "Hello World", if all goes OK,
 		// "Goodbye cruel world!" if something went wrong.
-		Messaging::Client c1ient(remoteIpAdres,
-				static_cast<unsigned short>(std::stoi(remotePort)), robot);
+		Messaging::Client c1ient(remoteAddress, robot);
 		Messaging::Message message(Messaging::EchoRequest, "Hello world!");
-		Logger::log("Sending message to " + remoteIpAdres + ":" + remotePort);
+		Logger::log("Sending message to " + remoteAddress.asString());
 		c1ient.dispatchMessage(message);
 	}
 }
@@ -5,7 +5,7 @@ namespace Application
 	/**
 	 *
 	 */
-	MainSettings::MainSettings() : drawOpenSet(true), speed(10), worldNumber(0)
+	MainSettings::MainSettings() : drawOpenSet(true), speed(10), worldNumber(0), frameRate(60)
 	{
 	}
 	/**
@@ -56,4 +56,18 @@ namespace Application
 	{
 		worldNumber = aWorldNumber;
 	}
+	/**
+	 *
+	 */
+	unsigned long MainSettings::getFrameRate() const
+	{
+		return frameRate;
+	}
+	/**
+	 *
+	 */
+	void MainSettings::setFrameRate( unsigned long aFrameRate)
+	{
+		frameRate = aFrameRate;
+	}
 } /* namespace Application */
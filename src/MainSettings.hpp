@@ -44,11 +44,20 @@ namespace Application
 			 *
 			 */
 			void setWorldNumber( unsigned long aWorldNumber);
+			/**
+			 * The maximum number of times per second the canvas is updated, 0 means unbounded
+			 */
+			unsigned long getFrameRate() const;
+			/**
+			 *
+			 */
+			void setFrameRate( unsigned long aFrameRate);
 
 		private:
 			bool drawOpenSet;
 			unsigned long speed;
 			unsigned long worldNumber;
+			unsigned long frameRate;
 	};
 
 } /* namespace Application */
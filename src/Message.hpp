@@ -3,6 +3,9 @@
 
 #include "Config.hpp"
 
+#include "ByteOrder.hpp"
+
+#include <cstdint>
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -20,9 +23,39 @@ namespace Messaging
 	struct Message
 	{
 			typedef std::string MessageBody;
+			/**
+			 * The flags in the header
+			 */
+			enum Flags
+			{
+				NoFlags = 0,
+				/**
+				 * On a request: the client subscribes, the server may send more than one response.
+				 * On a response: more responses to the same request may follow.
+				 */
+				Stream = 1
+			};
 
 			/**
+			 * The header that precedes every message on the wire.
+			 *
+			 * The header is written in a fixed size binary format of binaryHeaderLength bytes, all
+			 * numbers little-endian:
 			 *
+			 *  offset  size  field
+			 *       0     2  magic, the bytes 'R' 'W'
+			 *       2     1  major version (2)
+			 *       3     1  minor version (0)
+			 *       4     1  message type
+			 *       5     1  flags, see Message::Flags
+			 *       6     4  correlation id
+			 *      10     4  length of the body in bytes
+			 *      14     2  Fletcher-16 checksum of the bytes 0 to 13
+			 *
+			 * The ASCII format of the earlier versions ("ASIO" followed by the version characters
+			 * '1' '0' or '1' '1' and the numbers in decimal, without flags) is still understood, see toString()
+			 * and fromString(). All formats have at least binaryHeaderLength bytes so a reader
+			 * always starts with reading binaryHeaderLength bytes and then knows which format it got.
 			 */
 			struct MessageHeader
 			{
@@ -31,7 +64,9 @@ namespace Messaging
 					 */
 					MessageHeader() :
 									messageType( 0),
-									messageLength( 0)
+									messageLength( 0),
+									correlationId( 0),
+									flags( 0)
 					{
 					}
 					/**
@@ -40,9 +75,13 @@ namespace Messaging
 					 * @param aMessageLength
 					 */
 					MessageHeader( 	char aMessageType,
-									std::size_t aMessageLength) :
+									std::size_t aMessageLength,
+									unsigned long aCorrelationId = 0,
+									unsigned char aFlags = NoFlags) :
 									messageType( aMessageType),
-									messageLength( aMessageLength)
+									messageLength( aMessageLength),
+									correlationId( aCorrelationId),
+									flags( aFlags)
 					{
 					}
 					/**
@@ -51,43 +90,120 @@ namespace Messaging
 					 */
 					explicit MessageHeader(	const std::string& aMessageHeaderBuffer) :
 									messageType( 0),
-									messageLength( 0)
+									messageLength( 0),
+									correlationId( 0),
+									flags( 0)
 					{
 						fromString( aMessageHeaderBuffer);
 					}
+					/**
+					 * Writes the binary representation of this header into aBuffer, which must have room
+					 * for binaryHeaderLength bytes
+					 */
+					void encode( char* aBuffer) const
+					{
+						Base::storeLittleEndian( aBuffer, binaryMagic);
+						aBuffer[2] = binaryMajorVersion;
+						aBuffer[3] = binaryMinorVersion;
+						aBuffer[4] = messageType;
+						aBuffer[5] = static_cast< char >( flags);
+						Base::storeLittleEndian( aBuffer + 6, static_cast< std::uint32_t >( correlationId)); // @suppress("Avoid magic numbers")
+						Base::storeLittleEndian( aBuffer + 10, static_cast< std::uint32_t >( messageLength)); // @suppress("Avoid magic numbers")
+						Base::storeLittleEndian( aBuffer + checksumOffset, calculateChecksum( aBuffer));
+					}
+					/**
+					 * Reads the binary representation in aBuffer, binaryHeaderLength bytes, into this header
+					 *
+					 * @return false if aBuffer does not hold a binary header of a known version or the checksum is wrong
+					 */
+					bool decode( const char* aBuffer)
+					{
+						if (Base::loadLittleEndian< std::uint16_t >( aBuffer) != binaryMagic || aBuffer[2] != binaryMajorVersion || Base::loadLittleEndian< std::uint16_t >( aBuffer + checksumOffset) != calculateChecksum( aBuffer))
+						{
+							return false;
+						}
+						messageType = aBuffer[4];
+						flags = static_cast< unsigned char >( aBuffer[5]);
+						correlationId = Base::loadLittleEndian< std::uint32_t >( aBuffer + 6); // @suppress("Avoid magic numbers")
+						messageLength = Base::loadLittleEndian< std::uint32_t >( aBuffer + 10); // @suppress("Avoid magic numbers")
+						return true;
+					}
+					/**
+					 * @return true if aBuffer, at least binaryHeaderLength bytes, starts an ASCII header
+					 */
+					static bool isAsciiHeader( const char* aBuffer)
+					{
+						return aBuffer[0] == magicNumber1 && aBuffer[1] == magicNumber2 && aBuffer[2] == magicNumber3 && aBuffer[3] == magicNumber4;
+					}
+					/**
+					 * @return the length of the ASCII header that starts in aBuffer, 0 for an unknown version
+					 */
+					static std::size_t getAsciiHeaderLength( const char* aBuffer)
+					{
+						if (aBuffer[4] != majorVersion)
+						{
+							return 0;
+						}
+						switch (aBuffer[5])
+						{
+							case '0':
+							{
+								return 6 + charWidth + intWidth; // @suppress("Avoid magic numbers")
+							}
+							case '1':
+							{
+								return 6 + charWidth + intWidth + intWidth; // @suppress("Avoid magic numbers")
+							}
+							default:
+							{
+								return 0;
+							}
+						}
+					}
 					/**
 					 * The ASCII representation is suitable for parsing by MessageHeader::fromString.
 					 *
+					 * @param aMinorVersion '0' leaves out the correlation id for peers that only know version 1.0
 					 * @return ASCII string representation of the message header.
 					 */
-					std::string toString() const
+					std::string toString( char aMinorVersion = minorVersion) const
 					{
 						std::ostringstream os;
-						os << magicNumber1 << magicNumber2 << magicNumber3 << magicNumber4 << majorVersion << minorVersion << std::setw(charWidth) << static_cast<int>(messageType) << std::setw(intWidth) << messageLength;
+						os << magicNumber1 << magicNumber2 << magicNumber3 << magicNumber4 << majorVersion << aMinorVersion << std::setw(charWidth) << static_cast<int>(static_cast<unsigned char>(messageType)) << std::setw(intWidth) << messageLength;
+						if (aMinorVersion != '0')
+						{
+							os << std::setw(intWidth) << correlationId;
+						}
 						return os.str();
 					}
 					/**
 					 * Stores a ASCII representation of a message header into this header.
 					 * The format of the ASCII representation by MessageHeader::toString should
-					 * be suitable.
+					 * be suitable, version 1.0 without the correlation id is accepted as well.
+					 *
+					 * The numbers are read as fixed width fields, a stream would run two fields
+					 * together if the second one uses its full width.
 					 *
 					 * @param aString in the same format as MessageHeader::toString.
 					 */
 					void fromString( const std::string& aString)
 					{
-						std::istringstream is( aString);
-						char magic[4];
-						char major;
-						char minor;
-						is >> magic[0] >> magic[1] >> magic[2] >> magic[3] >> major >> minor >> std::setw(charWidth) >> reinterpret_cast<int&>(messageType) >> std::setw( intWidth) >> messageLength;
+						const std::size_t headerLength = aString.length() < 6 ? 0 : getAsciiHeaderLength( aString.data()); // @suppress("Avoid magic numbers")
+						if (headerLength == 0 || aString.length() < headerLength)
+						{
+							return;
+						}
+						const char* field = aString.data() + 6; // @suppress("Avoid magic numbers")
+						messageType = static_cast< char >( parseField( field, charWidth));
+						messageLength = parseField( field + charWidth, intWidth);
+						correlationId = headerLength > 6 + charWidth + intWidth ? parseField( field + charWidth + intWidth, intWidth) : 0; // @suppress("Avoid magic numbers")
 					}
 					/**
-					 * @return The length of the header in bytes
+					 * @return The length of the binary header in bytes
 					 */
 					std::size_t getHeaderLength() const
 					{
-						static std::size_t l = toString().length();
-						return l;
+						return binaryHeaderLength;
 					}
 					/**
 					 *
@@ -104,6 +220,20 @@ namespace Messaging
 					{
 						return messageLength;
 					}
+					/**
+					 * @return The id that the response to a request has in common with the request
+					 */
+					unsigned long getCorrelationId() const
+					{
+						return correlationId;
+					}
+					/**
+					 *
+					 */
+					unsigned char getFlags() const
+					{
+						return flags;
+					}
 					/**
 					 * @name Debug functions
 					 */
@@ -114,7 +244,7 @@ namespace Messaging
 					std::string asString() const
 					{
 						std::ostringstream os;
-						os << magicNumber1 << magicNumber2 << magicNumber3 << magicNumber4 << " " << majorVersion << " " <<  minorVersion << " " << static_cast<int>(messageType) << " " << messageLength;
+						os << "RW " << static_cast<int>(binaryMajorVersion) << " " << static_cast<int>(binaryMinorVersion) << " " << static_cast<int>(messageType) << " " << messageLength << " " << correlationId;
 						return os.str();
 					}
 					/**
@@ -126,20 +256,67 @@ namespace Messaging
 					}
 					//@}
 
+					static const std::size_t binaryHeaderLength = 16;
+					/**
+					 * A header with a longer body is refused by the readers, a corrupt or hostile length
+					 * must not make them allocate gigabytes
+					 */
+					static const std::size_t maxMessageLength = 64 * 1024 * 1024; // @suppress("Avoid magic numbers")
+					static const std::uint16_t binaryMagic = 0x5752; // 'R' 'W' in little-endian
+					static const char binaryMajorVersion = 2;
+					static const char binaryMinorVersion = 0;
+
 					static const char magicNumber1 = 'A';
 					static const char magicNumber2 = 'S';
 					static const char magicNumber3 = 'I';
 					static const char magicNumber4 = 'O';
 					static const char majorVersion = '1';
-					static const char minorVersion = '0';
+					static const char minorVersion = '1';
 					char messageType;
 					std::size_t messageLength;
+					unsigned long correlationId;
+					unsigned char flags;
+
+				private:
+					static const std::size_t checksumOffset = 14;
+					/**
+					 * Fletcher-16 over the bytes before the checksum
+					 */
+					static std::uint16_t calculateChecksum( const char* aBuffer)
+					{
+						std::uint16_t sum1 = 0;
+						std::uint16_t sum2 = 0;
+						for (std::size_t i = 0; i < checksumOffset; ++i)
+						{
+							sum1 = static_cast< std::uint16_t >( (sum1 + static_cast< unsigned char >( aBuffer[i])) % 255); // @suppress("Avoid magic numbers")
+							sum2 = static_cast< std::uint16_t >( (sum2 + sum1) % 255); // @suppress("Avoid magic numbers")
+						}
+						return static_cast< std::uint16_t >( (sum2 << 8) | sum1); // @suppress("Avoid magic numbers")
+					}
+					/**
+					 * Parses aWidth characters of decimal digits, leading spaces are skipped
+					 */
+					static unsigned long parseField(	const char* aField,
+														int aWidth)
+					{
+						unsigned long value = 0;
+						for (int i = 0; i < aWidth; ++i)
+						{
+							if (aField[i] >= '0' && aField[i] <= '9')
+							{
+								value = value * 10 + static_cast< unsigned long >( aField[i] - '0'); // @suppress("Avoid magic numbers")
+							}
+						}
+						return value;
+					}
 			}; // struct MessageHeader
 			/**
 			 *
 			 */
 			Message() :
-							messageType( 0)
+							messageType( 0),
+							correlationId( 0),
+							flags( NoFlags)
 			{
 			}
 			/**
@@ -147,7 +324,9 @@ namespace Messaging
 			 * @param aMessageType
 			 */
 			explicit Message( char aMessageType) :
-							messageType( aMessageType)
+							messageType( aMessageType),
+							correlationId( 0),
+							flags( NoFlags)
 			{
 			}
 			/**
@@ -158,6 +337,8 @@ namespace Messaging
 			Message( 	char aMessageType,
 						const std::string& aMessage) :
 							messageType( aMessageType),
+							correlationId( 0),
+							flags( NoFlags),
 							message( aMessage)
 			{
 			}
@@ -167,9 +348,15 @@ namespace Messaging
 			 */
 			Message( const Message& aMessage) :
 							messageType( aMessage.messageType),
+							correlationId( aMessage.correlationId),
+							flags( aMessage.flags),
 							message( aMessage.message)
 			{
 			}
+			/**
+			 * Takes over the body instead of copying it
+			 */
+			Message( Message&& aMessage) = default;
 			/**
 			 *
 			 */
@@ -178,13 +365,17 @@ namespace Messaging
 			 *
 			 */
 			Message& operator=(const Message& aMessage) = default;
+			/**
+			 *
+			 */
+			Message& operator=(Message&& aMessage) = default;
 			/**
 			 *
 			 * @return The header of this message
 			 */
 			MessageHeader getHeader() const
 			{
-				return MessageHeader( messageType, message.length());
+				return MessageHeader( messageType, message.length(), correlationId, flags);
 			}
 			/**
 			 *
@@ -193,6 +384,8 @@ namespace Messaging
 			void setHeader( const MessageHeader& aHeader)
 			{
 				setMessageType( aHeader.messageType);
+				setCorrelationId( aHeader.correlationId);
+				setFlags( aHeader.flags);
 				message.resize( aHeader.messageLength);
 			}
 			/**
@@ -211,6 +404,42 @@ namespace Messaging
 			{
 				messageType = aMessageType;
 			}
+			/**
+			 * A server copies the id of a request into the response, so a client with more requests
+			 * in flight on one connection knows which request a response belongs to
+			 */
+			unsigned long getCorrelationId() const
+			{
+				return correlationId;
+			}
+			/**
+			 *
+			 */
+			void setCorrelationId( unsigned long aCorrelationId)
+			{
+				correlationId = aCorrelationId;
+			}
+			/**
+			 * @return A combination of Flags
+			 */
+			unsigned char getFlags() const
+			{
+				return flags;
+			}
+			/**
+			 *
+			 */
+			void setFlags( unsigned char aFlags)
+			{
+				flags = aFlags;
+			}
+			/**
+			 *
+			 */
+			bool isStream() const
+			{
+				return (flags & Stream) != 0;
+			}
 			/**
 			 *
 			 * @return
@@ -259,6 +488,14 @@ namespace Messaging
 			 *
 			 */
 			char messageType;
+			/**
+			 *
+			 */
+			unsigned long correlationId;
+			/**
+			 *
+			 */
+			unsigned char flags;
 			/**
 			 *
 			 */
@@ -12,6 +12,31 @@ namespace Messaging
 {
 	class Message;
 
+	/**
+	 * The server side of a subscription, i.e. of a request with the Message::Stream flag. The
+	 * request handler may keep it and publish any number of messages to the subscriber later on.
+	 */
+	class Subscription
+	{
+		public:
+			/**
+			 *
+			 */
+			virtual ~Subscription() = default;
+			/**
+			 * Sends aMessage to the subscriber as one more response to the subscription request.
+			 * May be called from any thread.
+			 *
+			 * @return false if the subscriber is gone, the subscription can be forgotten
+			 */
+			virtual bool publish( const Message& aMessage) = 0;
+			/**
+			 * @return false if the subscriber is gone
+			 */
+			virtual bool isActive() const = 0;
+	}; // class Subscription
+	typedef std::shared_ptr< Subscription > SubscriptionPtr;
+
 	/**
 	 * Base server interface for handling remote requests
 	 * Classes derived from this interface can serve as a server in the Messaging protocol
@@ -34,6 +59,18 @@ namespace Messaging
 			 * @param aMessage in/out message containing the request (in) and response(out).
 			 */
 			virtual void handleRequest( Message& aMessage) = 0;
+			/**
+			 * Called instead of handleRequest for a request with the Message::Stream flag. aMessage is
+			 * returned as the first response, aSubscription can be used to send more. By default the
+			 * request is handled as an ordinary request.
+			 *
+			 * @param aMessage in/out message containing the request (in) and first response(out).
+			 */
+			virtual void handleSubscription(	Message& aMessage,
+												SubscriptionPtr UNUSEDPARAM(aSubscription))
+			{
+				handleRequest( aMessage);
+			}
 	}; // class RequestHandler
 	typedef std::shared_ptr< RequestHandler > RequestHandlerPtr;
 
@@ -42,8 +79,8 @@ namespace Messaging
 	 * Classes derived from this interface can serve as client in the Messaging protocol
 	 * by implementing this interface.
 	 *
-	 * A ResponseHandler that is passed to the Client and to its ClientSessions will live at least
-	 * as long as the Client and any outstanding ClientSessions.
+	 * A ResponseHandler that is passed to a Client is kept by the Connection until the response to
+	 * the request, or the last response to a subscription, is handled.
 	 */
 	class ResponseHandler
 	{
@@ -28,7 +28,15 @@ namespace Messaging
 		RobotLocationResponse,
 		// move bitch get out the way
 		OtherRobotOnPathRequest,
-		OtherRobotOnPathResponse
+		OtherRobotOnPathResponse,
+		// keep me posted, the responses are a stream of pose updates
+		PoseSubscriptionRequest,
+		PoseSubscriptionResponse,
+		// fire and forget over UDP, see TelemetrySender
+		PoseTelemetry,
+		// a local peer offers a SharedMemoryChannel, handled by the ServerSession itself
+		SharedMemoryRequest,
+		SharedMemoryResponse
 	};
 	//@}
 } /* namespace Messaging */
@@ -0,0 +1,75 @@
+#include "NotificationCoalescer.hpp"
+
+namespace Base
+{
+	/**
+	 *
+	 */
+	NotificationCoalescer::NotificationCoalescer( unsigned int aFrameRate /*= 60*/) :
+								dirty( false),
+								lastUpdate( FrameClock::now()),
+								frameRate( aFrameRate)
+	{
+	}
+	/**
+	 *
+	 */
+	void NotificationCoalescer::setFrameRate( unsigned int aFrameRate)
+	{
+		frameRate = aFrameRate;
+	}
+	/**
+	 *
+	 */
+	bool NotificationCoalescer::objectChanged( const ObjectId& anObjectId)
+	{
+		std::lock_guard< std::mutex > lock( changesBusy);
+		changes.objects.insert( anObjectId);
+		bool first = !dirty;
+		dirty = true;
+		return first;
+	}
+	/**
+	 *
+	 */
+	bool NotificationCoalescer::worldChanged()
+	{
+		std::lock_guard< std::mutex > lock( changesBusy);
+		changes.world = true;
+		bool first = !dirty;
+		dirty = true;
+		return first;
+	}
+	/**
+	 *
+	 */
+	NotificationCoalescer::FrameClock::duration NotificationCoalescer::getUpdateDelay() const
+	{
+		unsigned int rate = frameRate;
+		if (rate == 0)
+		{
+			return FrameClock::duration::zero();
+		}
+		FrameClock::duration framePeriod = std::chrono::duration_cast< FrameClock::duration >( std::chrono::seconds( 1)) / rate;
+
+		std::lock_guard< std::mutex > lock( changesBusy);
+		FrameClock::duration elapsed = FrameClock::now() - lastUpdate;
+		if (elapsed >= framePeriod)
+		{
+			return FrameClock::duration::zero();
+		}
+		return framePeriod - elapsed;
+	}
+	/**
+	 *
+	 */
+	NotificationCoalescer::Changes NotificationCoalescer::takeChanges()
+	{
+		std::lock_guard< std::mutex > lock( changesBusy);
+		Changes result;
+		std::swap( result, changes);
+		dirty = false;
+		lastUpdate = FrameClock::now();
+		return result;
+	}
+} // namespace Base
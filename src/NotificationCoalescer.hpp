@@ -0,0 +1,100 @@
+#ifndef NOTIFICATIONCOALESCER_HPP_
+#define NOTIFICATIONCOALESCER_HPP_
+
+#include "Config.hpp"
+
+#include "ObjectId.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_set>
+
+namespace Base
+{
+	/**
+	 * Collects change notifications from any thread until the GUI thread takes them, at most once per frame.
+	 *
+	 * A change only records the ObjectId of what changed. Only the first change after an update reports
+	 * that an update has to be requested, so however many notifications arrive there is at most one
+	 * update request outstanding. getUpdateDelay() tells the GUI thread how long to wait before the
+	 * update so the updates do not exceed the frame rate.
+	 */
+	class NotificationCoalescer
+	{
+		public:
+			/**
+			 * Frames are paced in wall clock time, also if the simulation runs in virtual time
+			 */
+			typedef std::chrono::steady_clock FrameClock;
+			/**
+			 *
+			 */
+			struct Changes
+			{
+					/**
+					 * The objects that notified a change
+					 */
+					std::unordered_set< ObjectId > objects;
+					/**
+					 * True if the world itself changed, e.g. objects were added or removed
+					 */
+					bool world = false;
+			};
+			/**
+			 *
+			 */
+			explicit NotificationCoalescer( unsigned int aFrameRate = 60); // @suppress("Avoid magic numbers")
+			/**
+			 *
+			 */
+			unsigned int getFrameRate() const
+			{
+				return frameRate;
+			}
+			/**
+			 * @param aFrameRate the maximum number of updates per second, 0 means unbounded
+			 */
+			void setFrameRate( unsigned int aFrameRate);
+			/**
+			 * @return true if this is the first change since the last update, the caller then has to request an update
+			 */
+			bool objectChanged( const ObjectId& anObjectId);
+			/**
+			 * @return true if this is the first change since the last update, the caller then has to request an update
+			 */
+			bool worldChanged();
+			/**
+			 * @return the time until the next update is allowed, zero if it is allowed now
+			 */
+			FrameClock::duration getUpdateDelay() const;
+			/**
+			 * Returns the changes since the last update and starts a new frame
+			 */
+			Changes takeChanges();
+
+		private:
+			/**
+			 *
+			 */
+			mutable std::mutex changesBusy;
+			/**
+			 *
+			 */
+			Changes changes;
+			/**
+			 * True if there are changes that were not taken yet
+			 */
+			bool dirty;
+			/**
+			 *
+			 */
+			FrameClock::time_point lastUpdate;
+			/**
+			 *
+			 */
+			std::atomic< unsigned int > frameRate;
+	};
+	// class NotificationCoalescer
+} // namespace Base
+#endif // NOTIFICATIONCOALESCER_HPP_
@@ -1,151 +1,116 @@
 #include "ObjectId.hpp"
 
-#include <boost/date_time/posix_time/posix_time.hpp>
-#include <boost/date_time/c_local_time_adjustor.hpp>
-
+#include <atomic>
+#include <cstdio>
 #include <ctime>
-#include <climits>
-#include <mutex>
+#include <sstream>
+#include <type_traits>
 
 namespace Base
 {
+	static_assert( std::is_trivially_copyable< ObjectId >::value, "ObjectId should be trivially copyable");
+	static_assert( sizeof( ObjectId) == 16, "ObjectId should be 128 bits"); // @suppress("Avoid magic numbers")
+
 	/**
-	 * newObjectId() uses gmtime() as it is faster than localtime().
-	 * We just calculates our offset to GMT once and cache it
+	 * FNV-1a, 32 bits
 	 */
-	struct GMTOffset
+	static std::uint32_t HashNamespace( const std::string& aNamespace)
 	{
-			GMTOffset()
-			{
-				// Get the current time in UTC and local form.
-				auto utc_time = boost::posix_time::microsec_clock::universal_time();
-				auto local_time = boost::date_time::c_local_adjustor< boost::posix_time::ptime >::utc_to_local( utc_time);
-
-				// Calculate the difference in milliseconds between local time and the UTC time.
-				auto time_t_diff = boost::posix_time::to_time_t( local_time) - boost::posix_time::to_time_t( utc_time);
-
-				offset = time_t_diff / 3600; // @suppress("Avoid magic numbers")
-			}
-			std::size_t offset;
-
-	};
-	static GMTOffset gmtOffset;
+		std::uint32_t hash = 2166136261u; // @suppress("Avoid magic numbers")
+		for (unsigned char c : aNamespace)
+		{
+			hash ^= c;
+			hash *= 16777619u; // @suppress("Avoid magic numbers")
+		}
+		return hash;
+	}
 
 	/**
 	 *
 	 */
 	/* static */ std::string ObjectId::objectIdNamespace = "";
 
-	static std::mutex newObjectIdMutex;
+	/**
+	 * Starts at 1 so a newObjectId() is never the null id
+	 */
+	static std::atomic< std::uint64_t > nextSequenceNumber( 1);
 
 	/* static */ObjectId ObjectId::newObjectId()
 	{
-		std::lock_guard< std::mutex > lock( newObjectIdMutex);
-
-		static time_t currentSecond = 0;
-		static unsigned long fraction = 0;
-
-		time_t newSecond = 0;
+		std::uint64_t sequenceNumber = nextSequenceNumber.fetch_add( 1, std::memory_order_relaxed);
 
 		struct timespec now;
+		clock_gettime( CLOCK_REALTIME, &now);
 
-		clock_gettime(CLOCK_REALTIME, &now);
-		newSecond = now.tv_sec;
-
-		// Reset seconds and fraction if in a new second
-		if (currentSecond < newSecond)
-		{
-			currentSecond = newSecond;
-			fraction = 0;
-		}
-
-		// Prevent overflow to 0 within the second. This should only happen on fast machines
-		// as the creation of the fraction part is processor speed dependent
-		if (fraction == ULONG_MAX)
-		{
-			// Wait for the next second
-			do
-			{
-				clock_gettime(CLOCK_REALTIME, &now);
-				newSecond = now.tv_sec;
-			}while(currentSecond >= newSecond);
-			currentSecond = newSecond;
-			fraction = 0;
-		}
-
-		// See https://stackoverflow.com/questions/41544774/localtime-takes-24-times-more-than-gmtime-performance-issue-on-linux
-		// for using gmtime + offset
-		//struct tm* timeStruct = localtime( &currentSecond); //
-		struct tm tm = *gmtime( &currentSecond);
+		std::uint64_t high = (static_cast< std::uint64_t >(HashNamespace( objectIdNamespace)) << 32) | static_cast< std::uint32_t >(now.tv_sec); // @suppress("Avoid magic numbers")
 
-		// We actually only use 27 chars but it could be 93, based on the maximum int values....
-		char timestampBuffer[93] = {'\0'};
-		sprintf( timestampBuffer,
-				 "%04d-%02d-%02d-%02zu-%02d-%02d-%06lu",
-				 tm.tm_year + 1900, // @suppress("Avoid magic numbers")
-				 tm.tm_mon + 1,
-				 tm.tm_mday,
-				 tm.tm_hour + gmtOffset.offset,
-				 tm.tm_min,
-				 tm.tm_sec,
-				 fraction++);
-
-		return ObjectId(timestampBuffer);
+		return ObjectId( high, sequenceNumber);
 	}
 	/**
 	 *
 	 */
-	bool ObjectId::operator==( const ObjectId& anObjectId) const
+	ObjectId::ObjectId( const std::string& anObjectIdString) :
+								high( 0),
+								low( 0)
 	{
-		return (static_cast<base>(*this) == static_cast<base>(anObjectId));
+		fromString( anObjectIdString);
 	}
 	/**
 	 *
 	 */
-	bool ObjectId::operator<( const ObjectId& anObjectId) const
+	std::string ObjectId::toString() const
 	{
-		return (static_cast<base>(*this) < static_cast<base>(anObjectId));
+		char buffer[33] = {'\0'}; // @suppress("Avoid magic numbers")
+		std::snprintf( buffer, sizeof( buffer), "%016llx%016llx", static_cast< unsigned long long >(high), static_cast< unsigned long long >(low));
+		return buffer;
 	}
 	/**
 	 *
 	 */
-	bool ObjectId::isNull() const
+	void ObjectId::fromString( const std::string& anObjectIdString)
 	{
-		if (base::empty())
+		high = 0;
+		low = 0;
+
+		unsigned long long newHigh = 0;
+		unsigned long long newLow = 0;
+		if (anObjectIdString.size() == 32 && // @suppress("Avoid magic numbers")
+			std::sscanf( anObjectIdString.c_str(), "%16llx%16llx", &newHigh, &newLow) == 2)
 		{
-			return true;
+			high = newHigh;
+			low = newLow;
 		}
-		return false;
 	}
 	/**
 	 *
 	 */
-	bool ObjectId::isValid() const
+	std::string ObjectId::asString() const
 	{
 		if (isNull())
 		{
-			return false;
+			return "";
 		}
-		return true;
+		return toString();
 	}
 	/**
 	 *
 	 */
-	/*virtual*/std::string ObjectId::asString() const
+	std::string ObjectId::asDebugString() const
 	{
 		if (isNull())
 		{
-			return "";
+			return "null";
 		}
-		return std::string( base::begin(), base::end());
-	}
 
-	/**
-	 *
-	 */
-	/*virtual*/std::string ObjectId::asDebugString() const
-	{
-		return asString();
+		std::time_t seconds = static_cast< std::time_t >(high & 0xFFFFFFFFu); // @suppress("Avoid magic numbers")
+		struct tm tm = *gmtime( &seconds);
+
+		char timestampBuffer[32] = {'\0'}; // @suppress("Avoid magic numbers")
+		std::strftime( timestampBuffer, sizeof( timestampBuffer), "%Y-%m-%d-%H-%M-%S", &tm);
+
+		std::ostringstream os;
+		os << toString() << " (namespace " << std::hex << (high >> 32) << std::dec << ", " << timestampBuffer << " UTC, #" << low << ")"; // @suppress("Avoid magic numbers")
+		return os.str();
 	}
 
 	std::ostream& operator<<( 	std::ostream& os,
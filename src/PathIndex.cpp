@@ -0,0 +1,217 @@
+#include "PathIndex.hpp"
+
+#include "Shape2DUtils.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	PathIndex::BoundingBox::BoundingBox() :
+								minX( std::numeric_limits< int >::max()),
+								minY( std::numeric_limits< int >::max()),
+								maxX( std::numeric_limits< int >::min()),
+								maxY( std::numeric_limits< int >::min())
+	{
+	}
+	/**
+	 *
+	 */
+	void PathIndex::BoundingBox::extend( const wxPoint& aPoint)
+	{
+		minX = std::min( minX, aPoint.x);
+		minY = std::min( minY, aPoint.y);
+		maxX = std::max( maxX, aPoint.x);
+		maxY = std::max( maxY, aPoint.y);
+	}
+	/**
+	 *
+	 */
+	void PathIndex::BoundingBox::extend( const BoundingBox& aBoundingBox)
+	{
+		minX = std::min( minX, aBoundingBox.minX);
+		minY = std::min( minY, aBoundingBox.minY);
+		maxX = std::max( maxX, aBoundingBox.maxX);
+		maxY = std::max( maxY, aBoundingBox.maxY);
+	}
+	/**
+	 *
+	 */
+	bool PathIndex::BoundingBox::isEmpty() const
+	{
+		return minX > maxX;
+	}
+	/**
+	 *
+	 */
+	bool PathIndex::BoundingBox::overlaps( const BoundingBox& aBoundingBox) const
+	{
+		return 	!isEmpty() && !aBoundingBox.isEmpty() &&
+				minX <= aBoundingBox.maxX && aBoundingBox.minX <= maxX &&
+				minY <= aBoundingBox.maxY && aBoundingBox.minY <= maxY;
+	}
+	/**
+	 *
+	 */
+	PathIndex::PathIndex() :
+								numberOfLeaves( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	PathIndex::PathIndex( const Path& aPath) :
+								numberOfLeaves( 0)
+	{
+		build( aPath);
+	}
+	/**
+	 *
+	 */
+	void PathIndex::build( const Path& aPath)
+	{
+		clear();
+
+		points.reserve( aPath.size());
+		for (const Vertex& vertex : aPath)
+		{
+			points.push_back( vertex.asPoint());
+		}
+
+		std::size_t numberOfSegments = getNumberOfSegments();
+		if (numberOfSegments == 0)
+		{
+			return;
+		}
+
+		std::size_t numberOfRuns = (numberOfSegments + RunLength - 1) / RunLength;
+		numberOfLeaves = 1;
+		while (numberOfLeaves < numberOfRuns)
+		{
+			numberOfLeaves *= 2;
+		}
+		nodes.resize( 2 * numberOfLeaves);
+
+		for (std::size_t segment = 0; segment < numberOfSegments; ++segment)
+		{
+			BoundingBox& leaf = nodes[numberOfLeaves + segment / RunLength];
+			leaf.extend( points[segment]);
+			leaf.extend( points[segment + 1]);
+		}
+		for (std::size_t node = numberOfLeaves - 1; node > 0; --node)
+		{
+			nodes[node] = nodes[2 * node];
+			nodes[node].extend( nodes[2 * node + 1]);
+		}
+	}
+	/**
+	 *
+	 */
+	void PathIndex::clear()
+	{
+		points.clear();
+		nodes.clear();
+		numberOfLeaves = 0;
+	}
+	/**
+	 *
+	 */
+	std::size_t PathIndex::getNumberOfSegments() const
+	{
+		return points.size() < 2 ? 0 : points.size() - 1;
+	}
+	/**
+	 *
+	 */
+	bool PathIndex::intersects(	const wxPoint* aPolygon,
+								std::size_t aNumberOfPoints,
+								std::size_t aFirstSegment,
+								std::size_t aLastSegment) const
+	{
+		aLastSegment = std::min( aLastSegment, getNumberOfSegments());
+		if (aNumberOfPoints == 0 || aFirstSegment >= aLastSegment)
+		{
+			return false;
+		}
+
+		BoundingBox polygonBox;
+		for (std::size_t i = 0; i < aNumberOfPoints; ++i)
+		{
+			polygonBox.extend( aPolygon[i]);
+		}
+
+		return intersects( 1, 0, numberOfLeaves, aPolygon, aNumberOfPoints, polygonBox, aFirstSegment, aLastSegment);
+	}
+	/**
+	 *
+	 */
+	bool PathIndex::intersects(	std::size_t aNode,
+								std::size_t aFirstLeaf,
+								std::size_t aLastLeaf,
+								const wxPoint* aPolygon,
+								std::size_t aNumberOfPoints,
+								const BoundingBox& aPolygonBox,
+								std::size_t aFirstSegment,
+								std::size_t aLastSegment) const
+	{
+		// The segments covered by this node are [aFirstLeaf * RunLength, aLastLeaf * RunLength)
+		if (aLastLeaf * RunLength <= aFirstSegment || aFirstLeaf * RunLength >= aLastSegment)
+		{
+			return false;
+		}
+		if (!nodes[aNode].overlaps( aPolygonBox))
+		{
+			return false;
+		}
+
+		if (aLastLeaf - aFirstLeaf == 1)
+		{
+			std::size_t first = std::max( aFirstSegment, aFirstLeaf * RunLength);
+			std::size_t last = std::min( aLastSegment, aLastLeaf * RunLength);
+			for (std::size_t segment = first; segment < last; ++segment)
+			{
+				if (segmentIntersects( segment, aPolygon, aNumberOfPoints, aPolygonBox))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		std::size_t middleLeaf = aFirstLeaf + (aLastLeaf - aFirstLeaf) / 2;
+		return 	intersects( 2 * aNode, aFirstLeaf, middleLeaf, aPolygon, aNumberOfPoints, aPolygonBox, aFirstSegment, aLastSegment) ||
+				intersects( 2 * aNode + 1, middleLeaf, aLastLeaf, aPolygon, aNumberOfPoints, aPolygonBox, aFirstSegment, aLastSegment);
+	}
+	/**
+	 *
+	 */
+	bool PathIndex::segmentIntersects(	std::size_t aSegment,
+										const wxPoint* aPolygon,
+										std::size_t aNumberOfPoints,
+										const BoundingBox& aPolygonBox) const
+	{
+		const wxPoint& start = points[aSegment];
+		const wxPoint& end = points[aSegment + 1];
+
+		BoundingBox segmentBox;
+		segmentBox.extend( start);
+		segmentBox.extend( end);
+		if (!segmentBox.overlaps( aPolygonBox))
+		{
+			return false;
+		}
+
+		for (std::size_t i = 0; i < aNumberOfPoints; ++i)
+		{
+			if (Utils::Shape2DUtils::intersect( aPolygon[i], aPolygon[(i + 1) % aNumberOfPoints], start, end))
+			{
+				return true;
+			}
+		}
+		// No edge crossed: the segment is either completely inside or completely outside
+		return Utils::Shape2DUtils::isInsidePolygon( aPolygon, static_cast< int >(aNumberOfPoints), start);
+	}
+} // namespace PathAlgorithm
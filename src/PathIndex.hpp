@@ -0,0 +1,133 @@
+#ifndef PATHINDEX_HPP_
+#define PATHINDEX_HPP_
+
+#include "Config.hpp"
+
+#include "AStar.hpp"
+#include "Point.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * A bounding volume hierarchy over the segments of a Path.
+	 *
+	 * Consecutive segments are grouped in runs of RunLength segments, each run gets an axis
+	 * aligned bounding box and the runs are the leaves of an implicit, complete binary tree
+	 * whose inner nodes hold the union of their children's boxes. The index is built once per
+	 * route and answers "does this footprint touch segments [first, last) of the path" by only
+	 * descending into nodes whose box overlaps the footprint's box and whose segment range
+	 * overlaps the requested range. A query does not allocate.
+	 */
+	class PathIndex
+	{
+		public:
+			/**
+			 * The number of path segments per leaf
+			 */
+			static const std::size_t RunLength = 8;
+			/**
+			 *
+			 */
+			PathIndex();
+			/**
+			 *
+			 */
+			explicit PathIndex( const Path& aPath);
+			/**
+			 * (Re)builds the index for aPath, any previous contents are discarded.
+			 */
+			void build( const Path& aPath);
+			/**
+			 *
+			 */
+			void clear();
+			/**
+			 *
+			 * @return the number of segments in the indexed path
+			 */
+			std::size_t getNumberOfSegments() const;
+			/**
+			 * Segment i runs from path[i] to path[i + 1].
+			 *
+			 * @param aPolygon The array of points of the footprint
+			 * @param aNumberOfPoints The number of points in the array
+			 * @param aFirstSegment The first segment to test
+			 * @param aLastSegment One past the last segment to test, clamped to the number of segments
+			 * @return true if any of the segments in [aFirstSegment, aLastSegment) intersects the footprint
+			 * or lies inside of it
+			 */
+			bool intersects(	const wxPoint* aPolygon,
+								std::size_t aNumberOfPoints,
+								std::size_t aFirstSegment,
+								std::size_t aLastSegment) const;
+
+		private:
+			/**
+			 *
+			 */
+			struct BoundingBox
+			{
+					/**
+					 * An empty box: any extend() will replace it
+					 */
+					BoundingBox();
+					/**
+					 *
+					 */
+					void extend( const wxPoint& aPoint);
+					/**
+					 *
+					 */
+					void extend( const BoundingBox& aBoundingBox);
+					/**
+					 *
+					 */
+					bool isEmpty() const;
+					/**
+					 *
+					 */
+					bool overlaps( const BoundingBox& aBoundingBox) const;
+
+					int minX;
+					int minY;
+					int maxX;
+					int maxY;
+			};
+			/**
+			 *
+			 */
+			bool intersects(	std::size_t aNode,
+								std::size_t aFirstLeaf,
+								std::size_t aLastLeaf,
+								const wxPoint* aPolygon,
+								std::size_t aNumberOfPoints,
+								const BoundingBox& aPolygonBox,
+								std::size_t aFirstSegment,
+								std::size_t aLastSegment) const;
+			/**
+			 *
+			 */
+			bool segmentIntersects(	std::size_t aSegment,
+									const wxPoint* aPolygon,
+									std::size_t aNumberOfPoints,
+									const BoundingBox& aPolygonBox) const;
+			/**
+			 * The vertices of the path
+			 */
+			std::vector< wxPoint > points;
+			/**
+			 * The implicit tree: node 1 is the root, the children of node n are 2n and 2n+1
+			 * and leaf l is node numberOfLeaves + l. Node 0 is unused.
+			 */
+			std::vector< BoundingBox > nodes;
+			/**
+			 * The number of leaves, always a power of 2
+			 */
+			std::size_t numberOfLeaves;
+	};
+	// class PathIndex
+} // namespace PathAlgorithm
+#endif // PATHINDEX_HPP_
@@ -0,0 +1,112 @@
+#ifndef POSEUPDATE_HPP_
+#define POSEUPDATE_HPP_
+
+#include "Config.hpp"
+
+#include "ByteOrder.hpp"
+#include "ObjectId.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+namespace Model
+{
+	/**
+	 * The pose of a robot as it is exchanged with the other robot world in the body of a
+	 * RobotLocationRequest and RobotLocationResponse.
+	 *
+	 * The body is encodedLength bytes, all numbers little-endian:
+	 *
+	 *  offset  size  field
+	 *       0     1  version (1)
+	 *       1     1  reserved, 0
+	 *       2     8  high word of the object id of the robot
+	 *      10     8  low word of the object id of the robot
+	 *      18     8  timestamp of the pose in microseconds of the clock of the sender
+	 *      26     4  x, float
+	 *      30     4  y, float
+	 *      34     4  heading in radians, float
+	 *      38     4  speed, float
+	 *
+	 * encode() and decode() work on a buffer of the caller and do not allocate.
+	 */
+	struct PoseUpdate
+	{
+			/**
+			 *
+			 */
+			void encode( char* aBuffer) const
+			{
+				aBuffer[0] = version;
+				aBuffer[1] = 0;
+				Base::storeLittleEndian( aBuffer + 2, robotId.getHigh());
+				Base::storeLittleEndian( aBuffer + 10, robotId.getLow()); // @suppress("Avoid magic numbers")
+				Base::storeLittleEndian( aBuffer + 18, timestamp); // @suppress("Avoid magic numbers")
+				Base::storeLittleEndian( aBuffer + 26, x); // @suppress("Avoid magic numbers")
+				Base::storeLittleEndian( aBuffer + 30, y); // @suppress("Avoid magic numbers")
+				Base::storeLittleEndian( aBuffer + 34, heading); // @suppress("Avoid magic numbers")
+				Base::storeLittleEndian( aBuffer + 38, speed); // @suppress("Avoid magic numbers")
+			}
+			/**
+			 * Overwrites aBuffer, its capacity is reused so a message body can be encoded in place
+			 */
+			void encode( std::string& aBuffer) const
+			{
+				aBuffer.resize( encodedLength);
+				encode( &aBuffer[0]);
+			}
+			/**
+			 * @return false if aBuffer does not hold a pose of a known version
+			 */
+			bool decode(	const char* aBuffer,
+							std::size_t aLength)
+			{
+				if (aLength < encodedLength || aBuffer[0] != version)
+				{
+					return false;
+				}
+				robotId = Base::ObjectId( Base::loadLittleEndian< std::uint64_t >( aBuffer + 2), Base::loadLittleEndian< std::uint64_t >( aBuffer + 10)); // @suppress("Avoid magic numbers")
+				timestamp = Base::loadLittleEndian< std::int64_t >( aBuffer + 18); // @suppress("Avoid magic numbers")
+				x = Base::loadLittleEndianFloat( aBuffer + 26); // @suppress("Avoid magic numbers")
+				y = Base::loadLittleEndianFloat( aBuffer + 30); // @suppress("Avoid magic numbers")
+				heading = Base::loadLittleEndianFloat( aBuffer + 34); // @suppress("Avoid magic numbers")
+				speed = Base::loadLittleEndianFloat( aBuffer + 38); // @suppress("Avoid magic numbers")
+				return true;
+			}
+			/**
+			 *
+			 */
+			bool decode( const std::string& aBuffer)
+			{
+				return decode( aBuffer.data(), aBuffer.length());
+			}
+			/**
+			 * @name Debug functions
+			 */
+			//@{
+			/**
+			 * Returns a 1-line description of the object
+			 */
+			std::string asString() const
+			{
+				std::ostringstream os;
+				os << robotId.asString() << " @" << timestamp << ": " << x << " " << y << " " << heading << " " << speed;
+				return os.str();
+			}
+			//@}
+
+			static const std::size_t encodedLength = 42;
+			static const char version = 1;
+
+			Base::ObjectId robotId;
+			std::int64_t timestamp = 0;
+			float x = 0;
+			float y = 0;
+			float heading = 0;
+			float speed = 0;
+	};
+	// struct PoseUpdate
+} // namespace Model
+#endif // POSEUPDATE_HPP_
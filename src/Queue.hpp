@@ -3,75 +3,241 @@
 
 #include "Config.hpp"
 
+#include "LockFreeQueue.hpp"
+
 #include <stddef.h>
 #include <condition_variable>
 #include <mutex>
-#include <queue>
 #include <optional>
 #include <atomic>
 
 namespace Base
 {
-	template< typename QueueContentType >
+	/**
+	 * A blocking queue on top of one of the lock free ring buffers in LockFreeQueue.hpp.
+	 *
+	 * As long as there is room and there are elements the queue never locks: a consumer only parks when
+	 * the queue is empty and a producer only parks when it is full. The other side only takes the
+	 * mutex to wake them if somebody is actually parked, and only once until they ran again.
+	 *
+	 * See benchmarks/QueueBenchmark.cpp for a comparison with the mutex and std::queue it replaced.
+	 *
+	 * Use SpscQueue as RingBuffer if there is exactly one producer and one consumer thread.
+	 */
+	template< typename QueueContentType, typename RingBuffer = MpmcQueue< QueueContentType > >
 	class Queue
 	{
 		public:
 			/**
 			 *
 			 */
-			void enqueue( const QueueContentType& anElement)
+			explicit Queue( size_t aCapacity = 16384) : // @suppress("Avoid magic numbers")
+						queue( aCapacity),
+						waitingConsumers( 0),
+						waitingProducers( 0),
+						signalledConsumers( 0),
+						producersSignalled( false)
 			{
-				std::unique_lock< std::mutex > lock( queueBusy);
-				queue.push( anElement);
-				queueFull.notify_one();
 			}
 			/**
+			 * Blocks while the queue is full
 			 *
+			 * @return false if the queue was shut down
 			 */
-			std::optional< QueueContentType > dequeue()
+			bool enqueue( const QueueContentType& anElement)
 			{
-				std::unique_lock< std::mutex > lock( queueBusy);
-				while (queue.empty() && stop.load() == false)
-					queueFull.wait( lock);
-
-				if (queue.empty())
+				if (stop.load())
 				{
-					return {};
-				}else
+					return false;
+				}
+				if (!queue.tryEnqueue( anElement))
 				{
-					QueueContentType front = queue.front();
-					queue.pop();
-					return front;
+					std::unique_lock< std::mutex > lock( queueBusy);
+					++waitingProducers;
+					for (;;)
+					{
+						// A consumer that saw the flag set before this has already woken everybody
+						producersSignalled.store( false);
+						std::atomic_thread_fence( std::memory_order_seq_cst);
+						if (stop.load() || queue.tryEnqueue( anElement))
+						{
+							break;
+						}
+						queueNotFull.wait( lock);
+					}
+					--waitingProducers;
+					if (stop.load())
+					{
+						return false;
+					}
 				}
+				wakeConsumer();
+				return true;
 			}
 			/**
+			 * Never blocks
 			 *
+			 * @return false if the queue is full or was shut down
 			 */
-			size_t size() const
+			bool tryEnqueue( const QueueContentType& anElement)
+			{
+				if (stop.load() || !queue.tryEnqueue( anElement))
+				{
+					return false;
+				}
+				wakeConsumer();
+				return true;
+			}
+			/**
+			 * Blocks while the queue is empty
+			 *
+			 * @return nothing if the queue was shut down and is empty
+			 */
+			std::optional< QueueContentType > dequeue()
 			{
-				return queue.size();
+				QueueContentType element;
+				if (dequeue( &element, 1) == 1)
+				{
+					return element;
+				}
+				return {};
 			}
 			/**
+			 * Blocks while the queue is empty and then moves up to aMaxCount elements into aBuffer
 			 *
+			 * @return the number of elements dequeued, 0 only if the queue was shut down and is empty
+			 */
+			size_t dequeue(	QueueContentType* aBuffer,
+							size_t aMaxCount)
+			{
+				size_t count = queue.tryDequeue( aBuffer, aMaxCount);
+				if (count == 0)
+				{
+					std::unique_lock< std::mutex > lock( queueBusy);
+					++waitingConsumers;
+					std::atomic_thread_fence( std::memory_order_seq_cst);
+					while ((count = queue.tryDequeue( aBuffer, aMaxCount)) == 0 && !stop.load())
+					{
+						queueNotEmpty.wait( lock);
+						if (signalledConsumers.load() > 0)
+						{
+							--signalledConsumers;
+						}
+						std::atomic_thread_fence( std::memory_order_seq_cst);
+					}
+					--waitingConsumers;
+				}
+				if (count > 0)
+				{
+					wakeProducers();
+				}
+				return count;
+			}
+			/**
+			 * Never blocks
+			 */
+			bool tryDequeue( QueueContentType& anElement)
+			{
+				if (queue.tryDequeue( anElement))
+				{
+					wakeProducers();
+					return true;
+				}
+				return false;
+			}
+			/**
+			 * Only exact if nobody is enqueueing or dequeueing
+			 */
+			size_t size() const
+			{
+				return queue.sizeApprox();
+			}
+			/**
+			 * Wakes all waiting producers and consumers. Consumers still get the remaining elements,
+			 * enqueueing fails from now on.
 			 */
 			void shutDown()
 			{
-				stop.store(true);
+				stop.store( true);
+				std::unique_lock< std::mutex > lock( queueBusy);
+				queueNotEmpty.notify_all();
+				queueNotFull.notify_all();
 			}
 
 		private:
 			/**
+			 * Parked producers are only woken once the queue is half empty. Waking one for every
+			 * dequeued element lets it park again right after a single enqueue, which costs a context
+			 * switch per element as soon as the consumer is the bottleneck.
+			 *
+			 * Once they are woken nobody takes the mutex again until one of them parks again.
+			 */
+			void wakeProducers()
+			{
+				std::atomic_thread_fence( std::memory_order_seq_cst);
+				if (waitingProducers.load() > 0 && !producersSignalled.load() && queue.sizeApprox() <= queue.getCapacity() / 2)
+				{
+					std::unique_lock< std::mutex > lock( queueBusy);
+					if (!producersSignalled.load())
+					{
+						producersSignalled.store( true);
+						queueNotFull.notify_all();
+					}
+				}
+			}
+			/**
+			 * The counter is incremented under the mutex before the waiter checks the queue for the last time,
+			 * and read here after the queue was changed, so either the waiter sees the change or we see the waiter.
 			 *
+			 * Only as many consumers are notified as there are parked. A consumer that was notified but did
+			 * not run yet will see the elements that were enqueued in the meantime, so until it runs the
+			 * producers do not take the mutex for every element.
 			 */
-			std::queue< QueueContentType > queue;
+			void wakeConsumer()
+			{
+				std::atomic_thread_fence( std::memory_order_seq_cst);
+				if (waitingConsumers.load() > signalledConsumers.load())
+				{
+					std::unique_lock< std::mutex > lock( queueBusy);
+					if (waitingConsumers.load() > signalledConsumers.load())
+					{
+						++signalledConsumers;
+						queueNotEmpty.notify_one();
+					}
+				}
+			}
 			/**
 			 *
 			 */
+			RingBuffer queue;
+			/**
+			 * Only used to park and wake, never to access the queue
+			 */
 			std::mutex queueBusy;
 			/**
 			 *
 			 */
-			std::condition_variable queueFull;
+			std::condition_variable queueNotEmpty;
+			/**
+			 *
+			 */
+			std::condition_variable queueNotFull;
+			/**
+			 *
+			 */
+			std::atomic< unsigned int > waitingConsumers;
+			/**
+			 *
+			 */
+			std::atomic< unsigned int > waitingProducers;
+			/**
+			 * The parked consumers that were notified and did not run yet
+			 */
+			std::atomic< unsigned int > signalledConsumers;
+			/**
+			 * Set when the parked producers were notified, cleared when one parks
+			 */
+			std::atomic< bool > producersSignalled;
 			/**
 			 *
 			 */
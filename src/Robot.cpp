@@ -8,19 +8,82 @@
 #include "MathUtils.hpp"
 #include "Message.hpp"
 #include "MessageTypes.hpp"
+#include "PoseUpdate.hpp"
 #include "RobotWorld.hpp"
 #include "Server.hpp"
 #include "Shape2DUtils.hpp"
+#include "SimulationScheduler.hpp"
+#include "TelemetrySender.hpp"
+#include "ThreadPool.hpp"
 #include "Wall.hpp"
 #include "WayPoint.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <ctime>
+#include <limits>
 #include <sstream>
-#include <thread>
 
 namespace Model {
+namespace {
+/**
+ * The names of the objects that are looked up on every drive tick, interned once
+ */
+const Base::SymbolId ButterName = Base::SymbolTable::intern("Butter");
+const Base::SymbolId PeanutName = Base::SymbolTable::intern("Peanut");
+const Base::SymbolId JellyName = Base::SymbolTable::intern("Jelly");
+const Base::SymbolId WayPointName = Base::SymbolTable::intern("WP");
+/**
+ * A route calculation that takes longer is given up, the robot then has no route. Real time, and
+ * only when the simulation runs in real time: in virtual time the result must not depend on the
+ * speed of the machine.
+ */
+const std::chrono::seconds PlanningDeadline(5); // @suppress("Avoid magic numbers")
+/**
+ * A heading change smaller than this is not worth a pose update
+ */
+const float HeadingDeadband = 0.01f; // @suppress("Avoid magic numbers")
+/**
+ * The smallest position change in pixels that is worth a pose update, -pose_deadband
+ */
+double getPoseDeadband() {
+	static const double deadband =
+			Application::MainApplication::isArgGiven("-pose_deadband") ?
+					std::stod(
+							Application::MainApplication::getArg(
+									"-pose_deadband").value) :
+					1.0;
+	return deadband;
+}
+/**
+ * The minimum time between 2 pose updates, from -pose_rate in updates per second, 0 is no limit
+ */
+std::chrono::microseconds getPoseInterval() {
+	static const unsigned long rate =
+			Application::MainApplication::isArgGiven("-pose_rate") ?
+					std::stoul(
+							Application::MainApplication::getArg("-pose_rate").value) :
+					0;
+	return std::chrono::microseconds(rate == 0 ? 0 : 1000000 / rate); // @suppress("Avoid magic numbers")
+}
+/**
+ * The sender of the pose telemetry if -remote_telemetry_port is given, nullptr otherwise
+ */
+Messaging::TelemetrySenderPtr getTelemetrySender() {
+	static const Messaging::TelemetrySenderPtr sender =
+			Application::MainApplication::isArgGiven("-remote_telemetry_port") ?
+					Messaging::CommunicationService::getCommunicationService().getTelemetrySender(
+							Robot::getRemoteAddress().isLocal() ?
+									"localhost" :
+									Robot::getRemoteAddress().host,
+							static_cast<unsigned short>(std::stoi(
+									Application::MainApplication::getArg(
+											"-remote_telemetry_port").value))) :
+					nullptr;
+	return sender;
+}
+} // namespace
 /**
  *
  */
@@ -37,11 +100,14 @@ Robot::Robot(const std::string &aName) :
  *
  */
 Robot::Robot(const std::string &aName, const wxPoint &aPosition) :
-		name(aName), size(wxDefaultSize), position(aPosition), front(0, 0), speed(
-				0.0), acting(false), driving(false), communicating(false), merged(
-				false) {
+		name(aName), nameId(Base::SymbolTable::intern(aName)), size(
+				wxDefaultSize), pose(Pose { aPosition, 0.0, 0.0, 0.0,
+				Base::Clock::getClock().now() }), holdPosition(false), routeReady(
+				false), routeVersion(0), pathPoint(0), acting(false), driving(false), backtracking(
+				false), communicating(false), merged(false), otherPoseTimestamp(0), subscribedToOtherRobot(
+				false), posePublished(false) {
 	// We use the real position for starters, not an estimated position.
-	startPosition = position;
+	startPosition = aPosition;
 }
 /**
  *
@@ -64,7 +130,11 @@ Robot::~Robot() {
  */
 void Robot::setName(const std::string &aName,
 		bool aNotifyObservers /*= true*/) {
+	Base::SymbolId oldNameId = nameId;
 	name = aName;
+	nameId = Base::SymbolTable::intern(aName);
+	RobotWorld::getRobotWorld().updateNameIndex(getObjectId(), oldNameId,
+			nameId);
 	if (aNotifyObservers == true) {
 		notifyObservers();
 	}
@@ -89,7 +159,10 @@ void Robot::setSize(const wxSize &aSize, bool aNotifyObservers /*= true*/) {
  */
 void Robot::setPosition(const wxPoint &aPosition,
 		bool aNotifyObservers /*= true*/) {
-	position = aPosition;
+	pose.update([&aPosition](Pose &aPose) {
+		aPose.position = aPosition;
+		aPose.timestamp = Base::Clock::getClock().now();
+	});
 	if (aNotifyObservers == true) {
 		notifyObservers();
 	}
@@ -98,14 +171,18 @@ void Robot::setPosition(const wxPoint &aPosition,
  *
  */
 BoundedVector Robot::getFront() const {
-	return front;
+	return pose.load().getFront();
 }
 /**
  *
  */
 void Robot::setFront(const BoundedVector &aVector,
 		bool aNotifyObservers /*= true*/) {
-	front = aVector;
+	pose.update([&aVector](Pose &aPose) {
+		aPose.frontX = aVector.x;
+		aPose.frontY = aVector.y;
+		aPose.timestamp = Base::Clock::getClock().now();
+	});
 	if (aNotifyObservers == true) {
 		notifyObservers();
 	}
@@ -114,13 +191,16 @@ void Robot::setFront(const BoundedVector &aVector,
  *
  */
 float Robot::getSpeed() const {
-	return speed;
+	return pose.load().speed;
 }
 /**
  *
  */
 void Robot::setSpeed(float aNewSpeed, bool aNotifyObservers /*= true*/) {
-	speed = aNewSpeed;
+	pose.update([aNewSpeed](Pose &aPose) {
+		aPose.speed = aNewSpeed;
+		aPose.timestamp = Base::Clock::getClock().now();
+	});
 	if (aNotifyObservers == true) {
 		notifyObservers();
 	}
@@ -130,10 +210,7 @@ void Robot::setSpeed(float aNewSpeed, bool aNotifyObservers /*= true*/) {
  */
 void Robot::startActing() {
 	acting = true;
-	std::thread newRobotThread([this] {
-		startDriving();
-	});
-	robotThread.swap(newRobotThread);
+	SimulationScheduler::getSimulationScheduler().addRobot(toPtr<Robot>());
 }
 /**
  *
@@ -141,23 +218,48 @@ void Robot::startActing() {
 void Robot::stopActing() {
 	acting = false;
 	driving = false;
-	robotThread.join();
+	cancelRoute();
+	SimulationScheduler::getSimulationScheduler().removeRobot(getObjectId());
 }
 /**
  *
  */
 void Robot::startDriving() {
 	driving = true;
-	goal = RobotWorld::getRobotWorld().getGoal("Jelly");
+	goal = RobotWorld::getRobotWorld().getGoal(JellyName);
+	{
+		// The path of a previous run does not start here
+		std::lock_guard<std::mutex> lock(routeBusy);
+		path.clear();
+		pathIndex.clear();
+		++routeVersion;
+	}
 	calculateRoute(goal);
 
-	drive();
+	// The runtime value always wins!!
+	setSpeed(
+			static_cast<float>(Application::MainApplication::getSettings().getSpeed()),
+			false);
+
+	// Compare a float/double with another float/double: use epsilon...
+	if (std::fabs(getSpeed() - 0.0) <= std::numeric_limits<float>::epsilon()) {
+		setSpeed(10.0, false); // @suppress("Avoid magic numbers")
+	}
+
+	Application::Logger::log(
+			__PRETTY_FUNCTION__ + std::string(": Drive the MF to goal"));
+
+	// We use the real position for starters, not an estimated position.
+	startPosition = getPosition();
+	pathPoint = 0;
+	backtracking = false;
 }
 /**
  *
  */
 void Robot::stopDriving() {
 	driving = false;
+	cancelRoute();
 }
 /**
  *
@@ -166,22 +268,24 @@ void Robot::startCommunicating() {
 	if (!communicating) {
 		communicating = true;
 
-		std::string localPort = "12345";
-		if (Application::MainApplication::isArgGiven("-local_port")) {
-			localPort =
-					Application::MainApplication::getArg("-local_port").value;
-		}
-
 		if (Messaging::CommunicationService::getCommunicationService().isStopped()) {
 			TRACE_DEVELOP("Restarting the Communication service");
 			Messaging::CommunicationService::getCommunicationService().restart();
 		}
 
-		server = std::make_shared<Messaging::Server>(
-				static_cast<unsigned short>(std::stoi(localPort)),
+		server = std::make_shared<Messaging::Server>(getLocalAddress(),
 				toPtr<Robot>());
 		Messaging::CommunicationService::getCommunicationService().registerServer(
 				server);
+
+		// The poses of the other robot may come in over UDP as well
+		if (Application::MainApplication::isArgGiven("-telemetry_port")) {
+			Messaging::CommunicationService::getCommunicationService().startTelemetryReceiver(
+					static_cast<unsigned short>(std::stoi(
+							Application::MainApplication::getArg(
+									"-telemetry_port").value)),
+					toPtr<Robot>());
+		}
 	}
 }
 /**
@@ -192,19 +296,53 @@ void Robot::stopCommunicating() {
 		communicating = false;
 		Messaging::CommunicationService::getCommunicationService().deregisterServer(
 				server);
-		std::string localPort = "12345";
-		if (Application::MainApplication::isArgGiven("-local_port")) {
-			localPort =
-					Application::MainApplication::getArg("-local_port").value;
+		if (Application::MainApplication::isArgGiven("-telemetry_port")) {
+			Messaging::CommunicationService::getCommunicationService().stopTelemetryReceiver(
+					static_cast<unsigned short>(std::stoi(
+							Application::MainApplication::getArg(
+									"-telemetry_port").value)));
 		}
-
-		Messaging::Client c1ient("localhost",
-				static_cast<unsigned short>(std::stoi(localPort)),
-				toPtr<Robot>());
+		Messaging::Client c1ient(getLocalAddress(), toPtr<Robot>());
 		Messaging::Message message(Messaging::StopCommunicatingRequest, "stop");
 		c1ient.dispatchMessage(message);
 	}
 }
+/**
+ *
+ */
+/* static */Messaging::Address Robot::getLocalAddress() {
+	if (Application::MainApplication::isArgGiven("-local")) {
+		return Messaging::Address::parse(
+				Application::MainApplication::getArg("-local").value);
+	}
+	std::string localPort = "12345";
+	if (Application::MainApplication::isArgGiven("-local_port")) {
+		localPort = Application::MainApplication::getArg("-local_port").value;
+	}
+	return Messaging::Address("localhost",
+			static_cast<unsigned short>(std::stoi(localPort)));
+}
+/**
+ *
+ */
+/* static */Messaging::Address Robot::getRemoteAddress() {
+	if (Application::MainApplication::isArgGiven("-remote")) {
+		return Messaging::Address::parse(
+				Application::MainApplication::getArg("-remote").value);
+	}
+	std::string remoteIpAdres = "localhost";
+	std::string remotePort = "12345";
+
+	if (Application::MainApplication::isArgGiven("-remote_ip")) {
+		remoteIpAdres =
+				Application::MainApplication::getArg("-remote_ip").value;
+	}
+	if (Application::MainApplication::isArgGiven("-remote_port")) {
+		remotePort = Application::MainApplication::getArg("-remote_port").value;
+	}
+	return Messaging::Address(remoteIpAdres,
+			static_cast<unsigned short>(std::stoi(remotePort)));
+}
 /**
  *
  */
@@ -224,101 +362,61 @@ bool Robot::intersects(const wxRegion &aRegion) const {
 /**
  *
  */
-wxPoint Robot::getFrontLeft() const {
+wxPoint Robot::getCorner(const wxPoint &aPosition, const BoundedVector &aFront,
+		int anXOffset, int aYOffset) const {
 	// x and y are pointing to top left now
-	int x = position.x - (size.x / 2);
-	int y = position.y - (size.y / 2);
+	int x = aPosition.x - (size.x / 2);
+	int y = aPosition.y - (size.y / 2);
 
-	wxPoint originalFrontLeft(x, y);
-	double angle = Utils::Shape2DUtils::getAngle(front) + 0.5 * Utils::PI;
+	wxPoint originalCorner(x + anXOffset, y + aYOffset);
+	double angle = Utils::Shape2DUtils::getAngle(aFront) + 0.5 * Utils::PI;
 
-	wxPoint frontLeft(
-			static_cast<int>((originalFrontLeft.x - position.x)
-					* std::cos(angle)
-					- (originalFrontLeft.y - position.y) * std::sin(angle)
-					+ position.x),
-			static_cast<int>((originalFrontLeft.y - position.y)
-					* std::cos(angle)
-					+ (originalFrontLeft.x - position.x) * std::sin(angle)
-					+ position.y));
+	wxPoint corner(
+			static_cast<int>((originalCorner.x - aPosition.x) * std::cos(angle)
+					- (originalCorner.y - aPosition.y) * std::sin(angle)
+					+ aPosition.x),
+			static_cast<int>((originalCorner.y - aPosition.y) * std::cos(angle)
+					+ (originalCorner.x - aPosition.x) * std::sin(angle)
+					+ aPosition.y));
 
-	return frontLeft;
+	return corner;
+}
+/**
+ *
+ */
+wxPoint Robot::getFrontLeft() const {
+	// Position and heading must belong together, another thread may be driving the robot
+	const Pose current = getPose();
+	return getCorner(current.position, current.getFront(), 0, 0);
 }
 /**
  *
  */
 wxPoint Robot::getFrontRight() const {
-	// x and y are pointing to top left now
-	int x = position.x - (size.x / 2);
-	int y = position.y - (size.y / 2);
-
-	wxPoint originalFrontRight(x + size.x, y);
-	double angle = Utils::Shape2DUtils::getAngle(front) + 0.5 * Utils::PI;
-
-	wxPoint frontRight(
-			static_cast<int>((originalFrontRight.x - position.x)
-					* std::cos(angle)
-					- (originalFrontRight.y - position.y) * std::sin(angle)
-					+ position.x),
-			static_cast<int>((originalFrontRight.y - position.y)
-					* std::cos(angle)
-					+ (originalFrontRight.x - position.x) * std::sin(angle)
-					+ position.y));
-
-	return frontRight;
+	// Position and heading must belong together, another thread may be driving the robot
+	const Pose current = getPose();
+	return getCorner(current.position, current.getFront(), size.x, 0);
 }
 /**
  *
  */
 wxPoint Robot::getBackLeft() const {
-	// x and y are pointing to top left now
-	int x = position.x - (size.x / 2);
-	int y = position.y - (size.y / 2);
-
-	wxPoint originalBackLeft(x, y + size.y);
-
-	double angle = Utils::Shape2DUtils::getAngle(front) + 0.5 * Utils::PI;
-
-	wxPoint backLeft(
-			static_cast<int>((originalBackLeft.x - position.x) * std::cos(angle)
-					- (originalBackLeft.y - position.y) * std::sin(angle)
-					+ position.x),
-			static_cast<int>((originalBackLeft.y - position.y) * std::cos(angle)
-					+ (originalBackLeft.x - position.x) * std::sin(angle)
-					+ position.y));
-
-	return backLeft;
+	// Position and heading must belong together, another thread may be driving the robot
+	const Pose current = getPose();
+	return getCorner(current.position, current.getFront(), 0, size.y);
 }
 /**
  *
  */
 wxPoint Robot::getBackRight() const {
-	// x and y are pointing to top left now
-	int x = position.x - (size.x / 2);
-	int y = position.y - (size.y / 2);
-
-	wxPoint originalBackRight(x + size.x, y + size.y);
-
-	double angle = Utils::Shape2DUtils::getAngle(front) + 0.5 * Utils::PI;
-
-	wxPoint backRight(
-			static_cast<int>((originalBackRight.x - position.x)
-					* std::cos(angle)
-					- (originalBackRight.y - position.y) * std::sin(angle)
-					+ position.x),
-			static_cast<int>((originalBackRight.y - position.y)
-					* std::cos(angle)
-					+ (originalBackRight.x - position.x) * std::sin(angle)
-					+ position.y));
-
-	return backRight;
+	// Position and heading must belong together, another thread may be driving the robot
+	const Pose current = getPose();
+	return getCorner(current.position, current.getFront(), size.x, size.y);
 }
 /**
  *
  */
 void Robot::handleNotification() {
-	//	std::unique_lock<std::recursive_mutex> lock(robotMutex);
-
 	static int update = 0;
 	if ((++update % 200) == 0) // @suppress("Avoid magic numbers")
 			{
@@ -340,7 +438,7 @@ void Robot::handleRequest(Messaging::Message &aMessage) {
 		// i.e. 2 async timers are involved:
 		// see CommunicationService::stopServer and Server::stopHandlingRequests
 		Messaging::CommunicationService::getCommunicationService().stopServer(
-				12345, true); // @suppress("Avoid magic numbers")
+				getLocalAddress(), true);
 
 		break;
 	}
@@ -354,6 +452,8 @@ void Robot::handleRequest(Messaging::Message &aMessage) {
 		aMessage.setBody("Let's do some merging: " + aMessage.asString());
 		merged = true;
 		RobotWorld::getRobotWorld().merge();
+		// The requester subscribes to this robot, this robot to the requester
+		subscribeToOtherRobot();
 		break;
 	}
 	case Messaging::RobotLocationRequest: {
@@ -362,11 +462,8 @@ void Robot::handleRequest(Messaging::Message &aMessage) {
 		}
 
 		aMessage.setMessageType(Messaging::RobotLocationResponse);
-
-		std::ostringstream os;
-		os << "Sending my location to other robot: " << position.x << " "
-				<< position.y << " " << getFront().asString();
-		aMessage.setBody(os.str());
+		// The request body has the same size, its buffer is reused
+		encodePose(aMessage.message);
 		break;
 	}
 	default: {
@@ -393,10 +490,12 @@ void Robot::handleResponse(const Messaging::Message &aMessage) {
 	case Messaging::MergeResponse: {
 		Application::Logger::log("fuck it we merge");
 		merged = true;
-		this->askForLocation();
+		this->subscribeToOtherRobot();
 		break;
 	}
-	case Messaging::RobotLocationResponse: {
+	case Messaging::RobotLocationResponse:
+	case Messaging::PoseSubscriptionResponse:
+	case Messaging::PoseTelemetry: {
 		if (merged) {
 			this->updateOtherRobot(aMessage.getBody());
 		}
@@ -414,6 +513,7 @@ void Robot::handleResponse(const Messaging::Message &aMessage) {
  *
  */
 std::string Robot::asString() const {
+	wxPoint position = getPosition();
 	std::ostringstream os;
 
 	os << "Robot " << name << " at (" << position.x << "," << position.y << ")";
@@ -424,6 +524,7 @@ std::string Robot::asString() const {
  *
  */
 std::string Robot::asDebugString() const {
+	wxPoint position = getPosition();
 	std::ostringstream os;
 
 	os << "Robot:\n";
@@ -437,185 +538,337 @@ std::string Robot::asDebugString() const {
  */
 void Robot::drive() {
 	try {
-		// The runtime value always wins!!
-		speed =
-				static_cast<float>(Application::MainApplication::getSettings().getSpeed());
+		if (!driving) {
+			return;
+		}
 
-		// Compare a float/double with another float/double: use epsilon...
-		if (std::fabs(speed - 0.0) <= std::numeric_limits<float>::epsilon()) {
-			setSpeed(10.0, false); // @suppress("Avoid magic numbers")
+		// A route that was calculated in the background is swapped in between 2 steps
+		if (updateRoute()) {
+			return;
 		}
 
-		Application::Logger::log(
-				__PRETTY_FUNCTION__ + std::string(": Drive the MF to goal"));
-
-		// We use the real position for starters, not an estimated position.
-		startPosition = position;
-
-		unsigned short pathPoint = 0;
-		while (position.x > 0 && position.x < 500 && position.y > 0
-				&& position.y < 500 && pathPoint < path.size()) // @suppress("Avoid magic numbers")
-		{
-			// Do the update
-			const PathAlgorithm::Vertex &vertex = path[pathPoint +=
-					static_cast<unsigned short>(speed)];
-			front = BoundedVector(vertex.asPoint(), position);
-			position.x = vertex.x;
-			position.y = vertex.y;
-			std::ostringstream os;
-			os << this->name << " is at x: " << position.x;
-			os << " and at y: " << position.y;
+		if (backtracking) {
+			// Back up along the path one step per tick, evade when back at the start
+			if (pathPoint != 0) {
+				pathPoint -= std::min(pathPoint,
+						static_cast<std::size_t>(getSpeed()));
+				const PathAlgorithm::Vertex &vertex = path[pathPoint];
+				setPose(vertex.asPoint(),
+						BoundedVector(vertex.asPoint(), getPosition()));
+				Application::Logger::log(
+						__PRETTY_FUNCTION__ + std::string(": backtracking"));
+				return;
+			}
+			backtracking = false;
+			evade();
+			return;
+		}
+
+		wxPoint position = getPosition();
+		if (!(position.x > 0 && position.x < 500 && position.y > 0
+				&& position.y < 500 && pathPoint + 1 < path.size())) // @suppress("Avoid magic numbers")
+				{
+			driving = false;
+			return;
+		}
+
+		// Do the update, never step beyond the end of the path
+		pathPoint = std::min(pathPoint + static_cast<std::size_t>(getSpeed()),
+				path.size() - 1);
+		const PathAlgorithm::Vertex &vertex = path[pathPoint];
+		wxPoint previousPosition = position;
+		position = vertex.asPoint();
+		BoundedVector front(position, previousPosition);
+
+		// A large step may jump over a thin wall or another robot, so sweep the
+		// whole move instead of only looking at the new position. The sweep is
+		// done before the pose is published so nobody sees the robot in a wall.
+		double timeOfImpact = 1.0;
+		if (sweptCollision(previousPosition, position, front, timeOfImpact)) {
+			position.x = previousPosition.x
+					+ static_cast<int>((position.x - previousPosition.x)
+							* timeOfImpact);
+			position.y = previousPosition.y
+					+ static_cast<int>((position.y - previousPosition.y)
+							* timeOfImpact);
+			setPose(position, front);
 
+			std::ostringstream os;
+			os << __PRETTY_FUNCTION__ << ": hit something at " << timeOfImpact
+					<< " of the step, stopped at (" << position.x << ","
+					<< position.y << ")";
 			Application::Logger::log(os.str());
 
-			WayPointPtr getOutOfMyWayPoint =
-					Model::RobotWorld::getRobotWorld().getWayPoint("WP");
-
-			if (merged) {
-				this->askForLocation();
-				if (this->otherRobotOnPath(pathPoint) || this->otherRobotWithinRadius(this->size.GetWidth())) {
-					if (toCloseToWall()) {
-						Application::Logger::log(
-								__PRETTY_FUNCTION__
-										+ std::string(": wall is to close"));
-						while (pathPoint != 0) {
-							const PathAlgorithm::Vertex &vertex =
-									path[pathPoint -=
-											static_cast<unsigned short>(speed)];
-							front = BoundedVector(vertex.asPoint(), position);
-							position.x = vertex.x;
-							position.y = vertex.y;
-							Application::Logger::log(
-									__PRETTY_FUNCTION__
-											+ std::string(": backtracking"));
-							notifyObservers();
-
-							// If there is no sleep_for here the robot will immediately be on its destination....
-							std::this_thread::sleep_for(
-									std::chrono::milliseconds(100)); // @suppress("Avoid magic numbers")
-
-							// this should be the last thing in the loop
-							if (driving == false) {
-								break;
-							}
-						}
-
-					}
+			driving = false;
+			return;
+		}
+		setPose(position, front);
+		std::ostringstream os;
+		os << this->name << " is at x: " << position.x;
+		os << " and at y: " << position.y;
+
+		Application::Logger::log(os.str());
+
+		WayPointPtr getOutOfMyWayPoint =
+				Model::RobotWorld::getRobotWorld().getWayPoint(WayPointName);
+
+		// The position of the other robot is streamed in by the subscription, see subscribeToOtherRobot
+		if (merged) {
+			if (this->otherRobotOnPath(pathPoint)
+					|| this->otherRobotWithinRadius(this->size.GetWidth())) {
+				if (toCloseToWall()) {
 					Application::Logger::log(
 							__PRETTY_FUNCTION__
-									+ std::string(": fuck you in ma way"));
-					driving = false;
-					signed short x = 0;
-					if (speed != 0) {
-						x = static_cast<signed short>(position.x
-								+ 100 * (front.y / speed));
-					} else {
-						x = static_cast<signed short>(position.x + 10);
-					}
-					signed short y = static_cast<signed short>(position.y);
-
-					std::ostringstream os;
-
-					os << front.x << " " << front.y;
-
-					Application::Logger::log(os.str());
-
-					if (!getOutOfMyWayPoint) {
-						Model::RobotWorld::getRobotWorld().newWayPoint("WP",
-								wxPoint(x, y));
-						getOutOfMyWayPoint =
-								Model::RobotWorld::getRobotWorld().getWayPoint(
-										"WP");
-					} else {
-						getOutOfMyWayPoint->setPosition(wxPoint(x, y));
-					}
-
-					calculateRoute(getOutOfMyWayPoint);
-					pathPoint = 0;
-
-					driving = true;
+									+ std::string(": wall is to close"));
+					backtracking = true;
+					return;
 				}
+				evade();
+				getOutOfMyWayPoint =
+						Model::RobotWorld::getRobotWorld().getWayPoint(
+								WayPointName);
 			}
+		}
 
-			// Stop on arrival or collision
-			if (arrived(goal)) {
-				Application::Logger::log(
-						__PRETTY_FUNCTION__ + std::string(": arrived"));
-				driving = false;
-			} else if (getOutOfMyWayPoint && arrived(getOutOfMyWayPoint)) {
-				Application::Logger::log(
-						__PRETTY_FUNCTION__
-								+ std::string(": arrived at waypoint"));
-				driving = false;
-
-				Model::RobotWorld::getRobotWorld().deleteWayPoint(
-						getOutOfMyWayPoint);
-				std::this_thread::sleep_for(std::chrono::milliseconds(10));
-				if (!goal) {
-					goal = Model::RobotWorld::getRobotWorld().getGoal("Jelly");
-				}
-				calculateRoute(goal);
-				pathPoint = 0;
-
-				driving = true;
-			} else if (collision()) {
-				Application::Logger::log(
-						__PRETTY_FUNCTION__
-								+ std::string(": Robot has fucking died"));
-				driving = false;
-			}
-
-			notifyObservers();
-
-			// If there is no sleep_for here the robot will immediately be on its destination....
-			std::this_thread::sleep_for(std::chrono::milliseconds(100)); // @suppress("Avoid magic numbers")
-
-			// this should be the last thing in the loop
-			if (driving == false) {
-				break;
+		// Stop on arrival or collision
+		if (arrived(goal)) {
+			Application::Logger::log(
+					__PRETTY_FUNCTION__ + std::string(": arrived"));
+			driving = false;
+		} else if (getOutOfMyWayPoint && arrived(getOutOfMyWayPoint)) {
+			Application::Logger::log(
+					__PRETTY_FUNCTION__ + std::string(": arrived at waypoint"));
+
+			Model::RobotWorld::getRobotWorld().deleteWayPoint(
+					getOutOfMyWayPoint);
+			if (!goal) {
+				goal = Model::RobotWorld::getRobotWorld().getGoal(JellyName);
 			}
-		} // while
+			calculateRoute(goal);
+		} else if (collision()) {
+			Application::Logger::log(
+					__PRETTY_FUNCTION__
+							+ std::string(": Robot has fucking died"));
+			driving = false;
+		}
 	} catch (std::exception &e) {
 		Application::Logger::log(
 				__PRETTY_FUNCTION__ + std::string(": ") + e.what());
 		std::cerr << __PRETTY_FUNCTION__ << ": " << e.what() << std::endl;
+		driving = false;
 	} catch (...) {
 		Application::Logger::log(
 				__PRETTY_FUNCTION__ + std::string(": unknown exception"));
 		std::cerr << __PRETTY_FUNCTION__ << ": unknown exception" << std::endl;
+		driving = false;
 	}
 }
 /**
  *
  */
-void Robot::calculateRoute(GoalPtr aGoal) {
-	path.clear();
-	if (aGoal) {
-		// Turn off logging if not debugging AStar
-		Application::Logger::setDisable();
+void Robot::evade() {
+	Application::Logger::log(
+			__PRETTY_FUNCTION__ + std::string(": fuck you in ma way"));
+	const Pose current = getPose();
+	const wxPoint &position = current.position;
+	const BoundedVector front = current.getFront();
+	const float speed = current.speed;
+
+	signed short x = 0;
+	if (speed != 0) {
+		x = static_cast<signed short>(position.x + 100 * (front.y / speed));
+	} else {
+		x = static_cast<signed short>(position.x + 10);
+	}
+	signed short y = static_cast<signed short>(position.y);
+
+	std::ostringstream os;
 
-		front = BoundedVector(aGoal->getPosition(), position);
-		//handleNotificationsFor( astar);
-		path = astar.search(position, aGoal->getPosition(), size);
-		//stopHandlingNotificationsFor( astar);
+	os << front.x << " " << front.y;
 
-		Application::Logger::setDisable(false);
+	Application::Logger::log(os.str());
+
+	WayPointPtr getOutOfMyWayPoint =
+			Model::RobotWorld::getRobotWorld().getWayPoint(WayPointName);
+	if (!getOutOfMyWayPoint) {
+		getOutOfMyWayPoint = Model::RobotWorld::getRobotWorld().newWayPoint(
+				"WP", wxPoint(x, y));
+	} else {
+		getOutOfMyWayPoint->setPosition(wxPoint(x, y));
 	}
+
+	calculateRoute(getOutOfMyWayPoint);
+}
+/**
+ *
+ */
+void Robot::setPose(const wxPoint &aPosition, const BoundedVector &aFront) {
+	pose.update([&aPosition, &aFront](Pose &aPose) {
+		aPose.position = aPosition;
+		aPose.frontX = aFront.x;
+		aPose.frontY = aFront.y;
+		aPose.timestamp = Base::Clock::getClock().now();
+	});
+}
+/**
+ *
+ */
+void Robot::calculateRoute(GoalPtr aGoal) {
+	if (!aGoal) {
+		cancelRoute();
+		std::lock_guard<std::mutex> lock(routeBusy);
+		path.clear();
+		pathIndex.clear();
+		++routeVersion;
+		return;
+	}
+	setFront(BoundedVector(aGoal->getPosition(), getPosition()), false);
+	requestRoute(aGoal->getPosition(), false);
 }
 
 void Robot::calculateRoute(WayPointPtr aWayPoint) {
-	path.clear();
-	if (aWayPoint) {
-		// Turn off logging if not debugging AStar
-		Application::Logger::setDisable();
+	if (!aWayPoint) {
+		cancelRoute();
+		std::lock_guard<std::mutex> lock(routeBusy);
+		path.clear();
+		pathIndex.clear();
+		++routeVersion;
+		return;
+	}
+	setFront(BoundedVector(aWayPoint->getPosition(), getPosition()), false);
+	requestRoute(aWayPoint->getPosition(), true);
+}
+/**
+ *
+ */
+void Robot::requestRoute(const wxPoint &aGoalPoint, bool aHoldPosition) {
+	std::shared_ptr<Base::CancellationToken> token =
+			Base::Clock::getClock().getMode() == Base::Clock::VirtualTime ?
+					std::make_shared<Base::CancellationToken>() :
+					std::make_shared<Base::CancellationToken>(
+							std::chrono::steady_clock::now()
+									+ PlanningDeadline);
+	{
+		std::lock_guard<std::mutex> lock(routeBusy);
+		if (planning) {
+			planning->cancel();
+		}
+		planning = token;
+		holdPosition = aHoldPosition;
+		routeReady = false;
+	}
 
-		front = BoundedVector(aWayPoint->getPosition(), position);
-		//handleNotificationsFor( astar);
-		path = astar.search(position, aWayPoint->getPosition(), size);
-		//stopHandlingNotificationsFor( astar);
+	std::weak_ptr<Robot> robot = toPtr<Robot>();
+	wxPoint start = getPosition();
+	wxSize robotSize = size;
+	Base::ThreadPool::getThreadPool().submit(
+			[robot, token, start, aGoalPoint, robotSize]() {
+				// Turn off logging if not debugging AStar
+				Application::Logger::setDisable();
+				PathAlgorithm::AStar astar;
+				PathAlgorithm::Path route;
+				try {
+					route = astar.search(start, aGoalPoint, robotSize, *token);
+				} catch (std::exception &e) {
+					// Deliver no route rather than nothing, waitForRoute would never return
+					Application::Logger::setDisable(false);
+					Application::Logger::log(
+							__PRETTY_FUNCTION__ + std::string(": ")
+									+ e.what());
+				}
+				Application::Logger::setDisable(false);
 
-		Application::Logger::setDisable(false);
+				// Superseded by another route or the robot was stopped
+				if (token->isCancelRequested()) {
+					return;
+				}
+				if (token->isExpired()) {
+					Application::Logger::log(
+							__PRETTY_FUNCTION__
+									+ std::string(
+											": no route within the deadline"));
+				}
+				PathAlgorithm::PathIndex routeIndex(route);
+				PathAlgorithm::OpenSet routeOpenSet = astar.getOpenSet();
+				if (RobotPtr self = robot.lock()) {
+					self->routeCalculated(token, route, routeIndex,
+							routeOpenSet);
+				}
+			});
+}
+/**
+ *
+ */
+void Robot::routeCalculated(
+		const std::shared_ptr<Base::CancellationToken> &aToken,
+		PathAlgorithm::Path &aPath, PathAlgorithm::PathIndex &aPathIndex,
+		PathAlgorithm::OpenSet &anOpenSet) {
+	std::lock_guard<std::mutex> lock(routeBusy);
+	if (planning != aToken) {
+		return;
 	}
+	plannedPath.swap(aPath);
+	std::swap(plannedPathIndex, aPathIndex);
+	plannedOpenSet.swap(anOpenSet);
+	routeReady = true;
+	routeCondition.notify_all();
+}
+/**
+ *
+ */
+void Robot::waitForRoute() {
+	std::unique_lock<std::mutex> lock(routeBusy);
+	routeCondition.wait(lock, [this] {
+		return !planning || routeReady;
+	});
+}
+/**
+ *
+ */
+bool Robot::updateRoute() {
+	std::lock_guard<std::mutex> lock(routeBusy);
+	if (routeReady) {
+		path.swap(plannedPath);
+		std::swap(pathIndex, plannedPathIndex);
+		openSet.swap(plannedOpenSet);
+		plannedPath.clear();
+		plannedPathIndex.clear();
+		plannedOpenSet.clear();
+		++routeVersion;
+		pathPoint = 0;
+		routeReady = false;
+		holdPosition = false;
+		planning.reset();
+		return false;
+	}
+	return planning && (holdPosition || pathPoint + 1 >= path.size());
+}
+/**
+ *
+ */
+void Robot::cancelRoute() {
+	std::lock_guard<std::mutex> lock(routeBusy);
+	if (planning) {
+		planning->cancel();
+		planning.reset();
+	}
+	routeReady = false;
+	holdPosition = false;
+	routeCondition.notify_all();
+}
+/**
+ *
+ */
+PathAlgorithm::OpenSet Robot::getOpenSet() const {
+	std::lock_guard<std::mutex> lock(routeBusy);
+	return openSet;
+}
+/**
+ *
+ */
+PathAlgorithm::Path Robot::getPath() const {
+	std::lock_guard<std::mutex> lock(routeBusy);
+	return path;
 }
 /**
  *
@@ -642,8 +895,9 @@ bool Robot::collision() {
 	wxPoint backLeft = getBackLeft();
 	wxPoint backRight = getBackRight();
 
-	const std::vector<WallPtr> &walls = RobotWorld::getRobotWorld().getWalls();
-	for (WallPtr wall : walls) {
+	// One version of the world for the whole check
+	WorldSnapshotPtr world = RobotWorld::getRobotWorld().getSnapshot();
+	for (WallPtr wall : world->walls) {
 		if (Utils::Shape2DUtils::intersect(frontLeft, frontRight,
 				wall->getPoint1(), wall->getPoint2())
 				|| Utils::Shape2DUtils::intersect(frontLeft, backLeft,
@@ -653,9 +907,7 @@ bool Robot::collision() {
 			return true;
 		}
 	}
-	const std::vector<RobotPtr> &robots =
-			RobotWorld::getRobotWorld().getRobots();
-	for (RobotPtr robot : robots) {
+	for (RobotPtr robot : world->robots) {
 		if (getObjectId() == robot->getObjectId()) {
 			continue;
 		}
@@ -666,116 +918,231 @@ bool Robot::collision() {
 	return false;
 }
 
-void Robot::askForLocation() {
-	Model::RobotPtr robot = Model::RobotWorld::getRobotWorld().getRobot(
-			"Butter");
+/**
+ *
+ */
+bool Robot::sweptCollision(const wxPoint &aPreviousPosition,
+		const wxPoint &aPosition, const BoundedVector &aFront,
+		double &aTimeOfImpact) {
+	wxPoint displacement(aPosition.x - aPreviousPosition.x,
+			aPosition.y - aPreviousPosition.y);
+	if (displacement.x == 0 && displacement.y == 0) {
+		return false;
+	}
 
-	if (!robot) {
+	// The box at the start of the move, already in the orientation of the move
+	wxPoint box[] = { getCorner(aPreviousPosition, aFront, 0, 0), getCorner(
+			aPreviousPosition, aFront, size.x, 0), getCorner(aPreviousPosition,
+			aFront, size.x, size.y), getCorner(aPreviousPosition, aFront, 0,
+			size.y) };
+
+	bool hit = false;
+	double earliest = 1.0;
+
+	// One version of the world for the whole check
+	WorldSnapshotPtr world = RobotWorld::getRobotWorld().getSnapshot();
+	for (WallPtr wall : world->walls) {
+		double time = 1.0;
+		if (Utils::Shape2DUtils::sweep(box, 4, displacement, wall->getPoint1(), // @suppress("Avoid magic numbers")
+				wall->getPoint2(), time) && time <= earliest) {
+			hit = true;
+			earliest = time;
+		}
+	}
+	for (RobotPtr robot : world->robots) {
+		if (getObjectId() == robot->getObjectId()) {
+			continue;
+		}
+		wxPoint otherBox[] = { robot->getFrontLeft(), robot->getFrontRight(),
+				robot->getBackRight(), robot->getBackLeft() };
+		for (int i = 0; i < 4; ++i) { // @suppress("Avoid magic numbers")
+			double time = 1.0;
+			if (Utils::Shape2DUtils::sweep(box, 4, displacement, otherBox[i], // @suppress("Avoid magic numbers")
+					otherBox[(i + 1) % 4], time) && time <= earliest) {
+				hit = true;
+				earliest = time;
+			}
+		}
+	}
+
+	if (hit) {
+		aTimeOfImpact = earliest;
+	}
+	return hit;
+}
+
+void Robot::subscribeToOtherRobot() {
+	if (subscribedToOtherRobot.exchange(true)) {
 		return;
 	}
 
-	std::ostringstream os;
-	os << __PRETTY_FUNCTION__ << " asking for location" << std::endl;
+	const Messaging::Address remoteAddress = getRemoteAddress();
+	Application::Logger::log(
+			__PRETTY_FUNCTION__ + std::string(" subscribing to ")
+					+ remoteAddress.asString());
+	Messaging::Client client(remoteAddress, toPtr<Robot>());
+
+	// The request carries our own pose so the other side has it right away
+	Messaging::Message request(Messaging::PoseSubscriptionRequest);
+	request.setFlags(Messaging::Message::Stream);
+	encodePose(request.message);
+	client.dispatchMessage(request);
+}
 
-	std::string remoteIpAdres = "localhost";
-	std::string remotePort = "12345";
+void Robot::handleSubscription(Messaging::Message &aMessage,
+		Messaging::SubscriptionPtr aSubscription) {
+	FUNCTRACE_TEXT_DEVELOP(aMessage.asString());
 
-	if (Application::MainApplication::isArgGiven("-remote_ip")) {
-		remoteIpAdres =
-				Application::MainApplication::getArg("-remote_ip").value;
+	if (aMessage.getMessageType() != Messaging::PoseSubscriptionRequest) {
+		handleRequest(aMessage);
+		return;
 	}
-	if (Application::MainApplication::isArgGiven("-remote_port")) {
-		remotePort = Application::MainApplication::getArg("-remote_port").value;
+	if (merged) {
+		this->updateOtherRobot(aMessage.getBody());
+	}
+	{
+		std::lock_guard<std::mutex> lock(poseSubscribersBusy);
+		poseSubscribers.push_back(aSubscription);
 	}
+	// The first update is the response to the subscription request
+	aMessage.setMessageType(Messaging::PoseSubscriptionResponse);
+	encodePose(aMessage.message);
+}
 
-	Application::Logger::log(os.str());
-	Messaging::Client client(remoteIpAdres,
-			static_cast<unsigned short>(std::stoi(remotePort)), robot);
+void Robot::publishPose() {
+	// Once merged the updates go over UDP if the other side listens for them, the
+	// subscriptions then only carry the first pose
+	const Messaging::TelemetrySenderPtr telemetry =
+			merged ? getTelemetrySender() : nullptr;
+
+	std::lock_guard<std::mutex> lock(poseSubscribersBusy);
+	if (poseSubscribers.empty() && !telemetry) {
+		return;
+	}
 
-	std::ostringstream location;
-	location << position.x << " " << position.y << " " << getFront().asString();
+	const PoseUpdate update = getPoseUpdate();
+	const Base::Clock::TimePoint now = Base::Clock::getClock().now();
+	if (posePublished) {
+		const bool changed = std::hypot(update.x - publishedPose.x,
+				update.y - publishedPose.y) >= getPoseDeadband()
+				|| std::fabs(update.heading - publishedPose.heading)
+						>= HeadingDeadband
+				|| update.speed != publishedPose.speed;
+		if (!changed || now - publishTime < getPoseInterval()) {
+			return;
+		}
+	}
 
-	client.dispatchMessage(
-			Messaging::Message(Messaging::RobotLocationRequest,
-					location.str()));
+	if (telemetry) {
+		Messaging::Message message(Messaging::PoseTelemetry);
+		update.encode(message.message);
+		telemetry->send(message);
+	} else {
+		Messaging::Message message(Messaging::PoseSubscriptionResponse);
+		update.encode(message.message);
+		poseSubscribers.erase(
+				std::remove_if(poseSubscribers.begin(), poseSubscribers.end(),
+						[&message](const Messaging::SubscriptionPtr &aSubscription) {
+							return !aSubscription->publish(message);
+						}), poseSubscribers.end());
+	}
+
+	publishedPose = update;
+	publishTime = now;
+	posePublished = true;
 }
 
-void Robot::updateOtherRobot(std::string otherMsgBody) {
-	std::stringstream is(otherMsgBody);
-	signed short x, y, bvx, bvy;
-	is >> x >> y >> bvx >> bvy;
+PoseUpdate Robot::getPoseUpdate() const {
+	const Pose current = getPose();
+
+	PoseUpdate update;
+	update.robotId = getObjectId();
+	update.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+			current.timestamp.time_since_epoch()).count();
+	update.x = static_cast<float>(current.position.x);
+	update.y = static_cast<float>(current.position.y);
+	update.heading = static_cast<float>(std::atan2(current.frontY,
+			current.frontX));
+	update.speed = current.speed;
+	return update;
+}
 
-	RobotPtr butterTheSecond = Model::RobotWorld::getRobotWorld().getRobot(
-			"Peanut");
-	if (!butterTheSecond) {
-		Model::RobotWorld::getRobotWorld().newRobot("Peanut", wxPoint(x, y));
-		butterTheSecond = Model::RobotWorld::getRobotWorld().getRobot("Peanut");
+void Robot::encodePose(std::string &aBuffer) const {
+	getPoseUpdate().encode(aBuffer);
+}
+
+void Robot::updateOtherRobot(const std::string &otherMsgBody) {
+	PoseUpdate update;
+	if (!update.decode(otherMsgBody)) {
+		TRACE_DEVELOP(
+				__PRETTY_FUNCTION__ + std::string(": not a pose update"));
+		return;
 	}
+	const wxPoint position(static_cast<int>(std::lround(update.x)),
+			static_cast<int>(std::lround(update.y)));
+
+	RobotPtr butterTheSecond;
+	{
+		// The responses are handled concurrently on the ThreadPool. The check, the creation of the
+		// other robot and its new pose are done under one lock, so there is only one other robot and
+		// an older pose can never overwrite a newer one.
+		std::lock_guard<std::mutex> lock(otherPoseBusy);
+		if (update.robotId == otherRobotId
+				&& update.timestamp < otherPoseTimestamp) {
+			return;
+		}
+		otherRobotId = update.robotId;
+		otherPoseTimestamp = update.timestamp;
 
-	butterTheSecond->setPosition(wxPoint(x, y));
+		butterTheSecond = Model::RobotWorld::getRobotWorld().getRobot(PeanutName);
+		if (!butterTheSecond) {
+			Model::RobotWorld::getRobotWorld().newRobot("Peanut", position);
+			butterTheSecond = Model::RobotWorld::getRobotWorld().getRobot(PeanutName);
+		}
 
-	BoundedVector b(bvx, bvy);
-	butterTheSecond->setFront(b);
+		// Position and heading arrive together and are published together
+		butterTheSecond->setPose(position,
+				BoundedVector(std::cos(update.heading),
+						std::sin(update.heading)));
+		butterTheSecond->setSpeed(update.speed, false);
+	}
+	butterTheSecond->notifyObservers();
 	std::ostringstream os;
-	os << butterTheSecond->name << " location data: " << otherMsgBody;
+	os << butterTheSecond->name << " location data: " << update.asString();
 	Application::Logger::log(os.str());
 }
 
 // checks whether the remote robot is within given radius. Used for checking an imminent colission
 bool Robot::otherRobotWithinRadius(signed long radius) {
-	RobotPtr butterTheSecond = Model::RobotWorld::getRobotWorld().getRobot("Peanut");
+	RobotPtr butterTheSecond = Model::RobotWorld::getRobotWorld().getRobot(PeanutName);
 
 	if (!butterTheSecond) return false;
 
-	return Utils::Shape2DUtils::distance(this->position, butterTheSecond->getPosition()) < radius;
+	return Utils::Shape2DUtils::distance(getPosition(), butterTheSecond->getPosition()) < radius;
 }
 
-bool Robot::otherRobotOnPath(unsigned short pathPoint) {
-	RobotPtr butterTheSecond = Model::RobotWorld::getRobotWorld().getRobot(
-			"Peanut");
+bool Robot::otherRobotOnPath(std::size_t pathPoint) {
+	RobotPtr butterTheSecond = Model::RobotWorld::getRobotWorld().getRobot(PeanutName);
 	if (!butterTheSecond) {
 		return false;
 	}
-	for (unsigned short vertexNr = pathPoint; vertexNr < pathPoint + 200;
-			vertexNr++) {
-		if (static_cast<unsigned long long>(vertexNr) + 1 >= path.size()) {
-			return false;
-		}
+	// Look ahead this many path segments
+	const std::size_t lookAhead = 200; // @suppress("Avoid magic numbers")
 
-		if (Utils::Shape2DUtils::intersect(butterTheSecond->getFrontLeft(),
-				butterTheSecond->getFrontRight(),
-				wxPoint(path[vertexNr].x, path[vertexNr].y),
-				wxPoint(path[vertexNr + 1].x, path[vertexNr + 1].y))
-				|| Utils::Shape2DUtils::intersect(
-						butterTheSecond->getFrontLeft(),
-						butterTheSecond->getBackLeft(),
-						wxPoint(path[vertexNr].x, path[vertexNr].y),
-						wxPoint(path[vertexNr + 1].x, path[vertexNr + 1].y))
-				|| Utils::Shape2DUtils::intersect(
-						butterTheSecond->getFrontRight(),
-						butterTheSecond->getBackRight(),
-						wxPoint(path[vertexNr].x, path[vertexNr].y),
-						wxPoint(path[vertexNr + 1].x, path[vertexNr + 1].y))
-				|| Utils::Shape2DUtils::intersect(
-						butterTheSecond->getBackLeft(),
-						butterTheSecond->getBackRight(),
-						wxPoint(path[vertexNr].x, path[vertexNr].y),
-						wxPoint(path[vertexNr + 1].x, path[vertexNr + 1].y))) {
-			return true;
-		}
-	}
-	return false;
+	wxPoint footprint[] = { butterTheSecond->getFrontLeft(),
+			butterTheSecond->getFrontRight(), butterTheSecond->getBackRight(),
+			butterTheSecond->getBackLeft() };
+	return pathIndex.intersects(footprint, 4, pathPoint, pathPoint + lookAhead); // @suppress("Avoid magic numbers")
 }
 
 bool Robot::toCloseToWall() {
 
-	RobotPtr butterTheSecond = Model::RobotWorld::getRobotWorld().getRobot(
-			"Peanut");
+	RobotPtr butterTheSecond = Model::RobotWorld::getRobotWorld().getRobot(PeanutName);
 	if (!butterTheSecond) {
 		return false;
 	}
-	std::vector<WallPtr> Walls = Model::RobotWorld::getRobotWorld().getWalls();
-	for (WallPtr wall : Walls) {
+	WorldSnapshotPtr world = Model::RobotWorld::getRobotWorld().getSnapshot();
+	for (WallPtr wall : world->walls) {
 		if (Utils::Shape2DUtils::isOnLine(wall->getPoint1(), wall->getPoint2(),
 				getFrontLeft(),
 				static_cast<int>(Utils::Shape2DUtils::distance(getFrontLeft(),
@@ -3,22 +3,32 @@
 
 #include "Config.hpp"
 
+#include "Address.hpp"
 #include "AStar.hpp"
 #include "BoundedVector.hpp"
+#include "Clock.hpp"
 #include "Message.hpp"
 #include "MessageHandler.hpp"
 #include "ModelObject.hpp"
 #include "Observer.hpp"
+#include "PathIndex.hpp"
 #include "Point.hpp"
+#include "PoseUpdate.hpp"
 #include "Region.hpp"
+#include "SeqLock.hpp"
 #include "Size.hpp"
+#include "SymbolTable.hpp"
 #include "WayPoint.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <string>
-#include <thread>
+#include <vector>
 
 namespace Messaging
 {
@@ -35,6 +45,33 @@ namespace Model
 	class Goal;
 	typedef std::shared_ptr< Goal > GoalPtr;
 
+	/**
+	 * Where a robot is and where it is heading for at a moment in time. Published by the thread that
+	 * drives the robot and read by everybody else as a whole, see Robot::getPose.
+	 */
+	struct Pose
+	{
+			/**
+			 *
+			 */
+			BoundedVector getFront() const
+			{
+				return BoundedVector( frontX, frontY);
+			}
+
+			wxPoint position;
+			/**
+			 * The heading, BoundedVector itself can not be copied as raw memory
+			 */
+			double frontX;
+			double frontY;
+			float speed;
+			/**
+			 * The time of the last change
+			 */
+			Base::Clock::TimePoint timestamp;
+	};
+
 	/**
 	 *
 	 */
@@ -63,10 +100,18 @@ namespace Model
 			/**
 			 *
 			 */
-			std::string getName() const
+			const std::string& getName() const
 			{
 				return name;
 			}
+			/**
+			 *
+			 * @return the interned name, cheap to compare and hash
+			 */
+			Base::SymbolId getNameId() const
+			{
+				return nameId;
+			}
 			/**
 			 *
 			 */
@@ -86,13 +131,21 @@ namespace Model
 			 */
 			wxPoint getPosition() const
 			{
-				return position;
+				return pose.load().position;
 			}
 			/**
 			 *
 			 */
 			void setPosition(	const wxPoint& aPosition,
 								bool aNotifyObservers = true);
+			/**
+			 * Returns position, heading and speed as one consistent whole without locking, so
+			 * code that needs more than one of them should use this instead of the separate getters
+			 */
+			Pose getPose() const
+			{
+				return pose.load();
+			}
 			/**
 			 *
 			 */
@@ -136,9 +189,16 @@ namespace Model
 				return driving;
 			}
 			/**
-			 *
+			 * Starts calculating the route to the goal in the background and prepares for driving it. Called by the
+			 * SimulationScheduler on the first tick after startActing().
 			 */
 			virtual void startDriving();
+			/**
+			 * Blocks until the route calculation in progress, if any, is finished or cancelled. The
+			 * SimulationScheduler calls this in virtual time, so a robot starts driving a new route on
+			 * the same tick in every run instead of whenever the ThreadPool happens to be done.
+			 */
+			void waitForRoute();
 			/**
 			 *
 			 */
@@ -153,7 +213,8 @@ namespace Model
 			}
 			/**
 			 * Starts a ServerConnection that listens at port 12345 unless given
-			 * an other port by specifying a command line argument -local_port=port
+			 * an other port by specifying a command line argument -local_port=port,
+			 * or an other address with -local=unix:///path/of/socket
 			 */
 			void startCommunicating();
 			/**
@@ -163,6 +224,17 @@ namespace Model
 			 *
 			 */
 			void stopCommunicating();
+			/**
+			 * @return The address the server of this robot world listens on: the -local argument,
+			 * e.g. unix:///tmp/robotworld.sock, or else localhost at -local_port, 12345 by default
+			 */
+			static Messaging::Address getLocalAddress();
+			/**
+			 * @return The address of the other robot world: the -remote argument, e.g.
+			 * tcp://host:port or unix:///tmp/robotworld.sock, or else -remote_ip at -remote_port,
+			 * localhost at 12345 by default
+			 */
+			static Messaging::Address getRemoteAddress();
 			/**
 			 *
 			 */
@@ -199,18 +271,20 @@ namespace Model
 			virtual void handleNotification() override;
 			//@}
 			/**
-			 *
+			 * The open set of the last finished route calculation
 			 */
-			PathAlgorithm::OpenSet getOpenSet() const
-			{
-				return astar.getOpenSet();
-			}
+			PathAlgorithm::OpenSet getOpenSet() const;
 			/**
 			 *
 			 */
-			PathAlgorithm::Path getPath() const
+			PathAlgorithm::Path getPath() const;
+			/**
+			 * @return a number that changes whenever the path or the open set change, so a view only
+			 * has to copy them if they did
+			 */
+			unsigned long getRouteVersion() const
 			{
-				return path;
+				return routeVersion.load();
 			}
 			/**
 			 * @name Messaging::MessageHandler functions
@@ -219,18 +293,31 @@ namespace Model
 			/**
 			 * This function is called by a ServerSesssion whenever a message is received. If the request is handled,
 			 * any response *must* be set in the Message argument. The message argument is then echoed back to the
-			 * requester, probably a ClientSession.
+			 * requester, probably a Connection of a Client.
 			 *
 			 * @see Messaging::RequestHandler::handleRequest( Messaging::Message& aMessage)
 			 */
 			virtual void handleRequest( Messaging::Message& aMessage);
 			/**
-			 * This function is called by a ClientSession whenever a response to a previous request is received.
+			 * This function is called by a Connection whenever a response to a previous request is received.
 			 *
 			 * @see Messaging::ResponseHandler::handleResponse( const Messaging::Message& aMessage)
 			 */
 			virtual void handleResponse( const Messaging::Message& aMessage);
+			/**
+			 * A PoseSubscriptionRequest registers aSubscription for the pose updates of this robot,
+			 * any other request is handled by handleRequest.
+			 *
+			 * @see Messaging::RequestHandler::handleSubscription( Messaging::Message& aMessage, Messaging::SubscriptionPtr aSubscription)
+			 */
+			virtual void handleSubscription(	Messaging::Message& aMessage,
+												Messaging::SubscriptionPtr aSubscription) override;
 			//@}
+			/**
+			 * Sends the pose to the subscribers if it changed more than the deadband since the last update
+			 * and the last update is longer ago than the update interval. Called once per simulation tick.
+			 */
+			void publishPose();
 			/**
 			 * @name Debug functions
 			 */
@@ -253,16 +340,22 @@ namespace Model
 			wxPoint startPosition;
 			//@}
 
-		protected:
 			/**
-			 *
+			 * Advances the robot one step along its path. Called by the SimulationScheduler
+			 * once per tick as long as the robot is driving.
 			 */
 			void drive();
+
+		protected:
 			/**
-			 *
+			 * Starts calculating the route to aGoal in the background. The robot keeps driving its
+			 * current path until the new route is ready.
 			 */
 			void calculateRoute( GoalPtr aGoal);
-
+			/**
+			 * Starts calculating the route to aWayPoint in the background. The robot holds its
+			 * position until the new route is ready.
+			 */
 			void calculateRoute( WayPointPtr aWayPoint);
 			/**
 			 *
@@ -273,39 +366,93 @@ namespace Model
 			 *
 			 */
 			bool collision();
-		private:
 			/**
+			 * Sweeps the robot's box, heading for aFront, from aPreviousPosition to aPosition against
+			 * the walls and the other robots. The pose of the robot itself is not used.
 			 *
+			 * @param aPreviousPosition
+			 * @param aPosition The position the robot is about to move to
+			 * @param aFront The heading during the move
+			 * @param aTimeOfImpact Set to the fraction [0,1] of the move at which the first contact happens
+			 * @return true if the robot hit something while moving
 			 */
-			std::string name;
+			bool sweptCollision(	const wxPoint& aPreviousPosition,
+									const wxPoint& aPosition,
+									const BoundedVector& aFront,
+									double& aTimeOfImpact);
 			/**
-			 *
+			 * @param anXOffset, aYOffset The corner in the box of the robot before it is turned, from its top left
+			 * @return The corner of the robot at aPosition heading for aFront
 			 */
-			wxSize size;
+			wxPoint getCorner(	const wxPoint& aPosition,
+								const BoundedVector& aFront,
+								int anXOffset,
+								int aYOffset) const;
+		private:
 			/**
 			 *
 			 */
-			wxPoint position;
+			std::string name;
 			/**
 			 *
 			 */
-			BoundedVector front;
+			Base::SymbolId nameId;
 			/**
 			 *
 			 */
-			float speed;
+			wxSize size;
+			/**
+			 * Position, heading and speed. Written by the thread that drives the robot (and
+			 * the GUI when the robot is dragged around), read by all threads.
+			 */
+			Base::SeqLock< Pose > pose;
 			/**
 			 *
 			 */
 			GoalPtr goal;
 			/**
-			 *
+			 * Only changed by the drive step, which swaps in a new route between 2 steps
 			 */
-			PathAlgorithm::AStar astar;
+			PathAlgorithm::Path path;
+			/**
+			 * Always belongs to path
+			 */
+			PathAlgorithm::PathIndex pathIndex;
 			/**
 			 *
 			 */
-			PathAlgorithm::Path path;
+			PathAlgorithm::OpenSet openSet;
+			/**
+			 * Guards the planned route below and the swapping of path, pathIndex and openSet
+			 */
+			mutable std::mutex routeBusy;
+			/**
+			 * Notified when planning finishes or is cancelled, see waitForRoute
+			 */
+			std::condition_variable routeCondition;
+			/**
+			 * The route calculation in progress, if any
+			 */
+			std::shared_ptr< Base::CancellationToken > planning;
+			/**
+			 * True if the robot should not drive its current path while planning
+			 */
+			bool holdPosition;
+			/**
+			 * True if the planned route is ready to be swapped in
+			 */
+			bool routeReady;
+			PathAlgorithm::Path plannedPath;
+			PathAlgorithm::PathIndex plannedPathIndex;
+			PathAlgorithm::OpenSet plannedOpenSet;
+			/**
+			 * Incremented under routeBusy whenever path or openSet change
+			 */
+			std::atomic< unsigned long > routeVersion;
+			/**
+			 * The position on path
+			 */
+			std::size_t pathPoint;
 			/**
 			 *
 			 */
@@ -314,6 +461,10 @@ namespace Model
 			 *
 			 */
 			bool driving;
+			/**
+			 * True while backing up before evading the other robot
+			 */
+			bool backtracking;
 			/**
 			 *
 			 */
@@ -323,21 +474,74 @@ namespace Model
 			 */
 			bool merged;
 			/**
-			 *
+			 * The robot and the timestamp of the latest pose that was received from the other robot world.
+			 * otherPoseBusy also guards the creation of the other robot and the setting of its pose.
 			 */
-			std::thread robotThread;
+			std::mutex otherPoseBusy;
+			Base::ObjectId otherRobotId;
+			std::int64_t otherPoseTimestamp;
 			/**
-			 *
+			 * True once this robot subscribed to the other robot
+			 */
+			std::atomic< bool > subscribedToOtherRobot;
+			/**
+			 * The subscribers to the pose of this robot and what they got last
 			 */
-			mutable std::recursive_mutex robotMutex;
+			std::mutex poseSubscribersBusy;
+			std::vector< Messaging::SubscriptionPtr > poseSubscribers;
+			PoseUpdate publishedPose;
+			Base::Clock::TimePoint publishTime;
+			bool posePublished;
 			/**
 			 *
 			 */
 			Messaging::ServerPtr server;
 
-			void askForLocation();
-			void updateOtherRobot(std::string otherMsgBody);
-			bool otherRobotOnPath(unsigned short pathPoint);
+			/**
+			 * Plans a route to a way point next to the current position to get out of the way of the other robot
+			 */
+			void evade();
+			/**
+			 * Cancels the current route calculation and starts a new one to aGoalPoint on the ThreadPool
+			 */
+			void requestRoute(	const wxPoint& aGoalPoint,
+								bool aHoldPosition);
+			/**
+			 * Called from the ThreadPool when the route calculation with aToken is finished
+			 */
+			void routeCalculated(	const std::shared_ptr< Base::CancellationToken >& aToken,
+									PathAlgorithm::Path& aPath,
+									PathAlgorithm::PathIndex& aPathIndex,
+									PathAlgorithm::OpenSet& anOpenSet);
+			/**
+			 * Swaps in a route that was calculated in the background
+			 *
+			 * @return true if the robot has to wait for a route that is still being calculated
+			 */
+			bool updateRoute();
+			/**
+			 * Cancels the route calculation in progress, if any
+			 */
+			void cancelRoute();
+			/**
+			 * Publishes a new position and heading, the speed is kept
+			 */
+			void setPose(	const wxPoint& aPosition,
+							const BoundedVector& aFront);
+			/**
+			 * Subscribes to the pose updates of the robot in the other robot world, once
+			 */
+			void subscribeToOtherRobot();
+			/**
+			 *
+			 */
+			PoseUpdate getPoseUpdate() const;
+			/**
+			 * Encodes the current pose as a PoseUpdate into aBuffer
+			 */
+			void encodePose(std::string& aBuffer) const;
+			void updateOtherRobot(const std::string& otherMsgBody);
+			bool otherRobotOnPath(std::size_t pathPoint);
 			bool otherRobotWithinRadius(signed long radius);
 
 			bool toCloseToWall();
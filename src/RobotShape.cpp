@@ -10,6 +10,7 @@
 #include "Shape2DUtils.hpp"
 #include "Trace.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 namespace View
@@ -19,8 +20,10 @@ namespace View
 	 */
 	RobotShape::RobotShape( Model::RobotPtr aRobot) :
 								RectangleShape( std::dynamic_pointer_cast<Model::ModelObject>(aRobot), aRobot->getPosition(), aRobot->getName()),
-								robotWorldCanvas(nullptr)
+								robotWorldCanvas(nullptr),
+								routeVersion( aRobot->getRouteVersion() - 1)
 	{
+		followRoute();
 	}
 	/**
 	 *
@@ -67,8 +70,8 @@ namespace View
 	 */
 	void RobotShape::handleNotification()
 	{
-		setCentre( getRobot()->getPosition());
-		robotWorldCanvas->handleNotification();
+		// Called from the thread that moved the robot, the canvas moves the shape in the main thread
+		robotWorldCanvas->handleNotification( getRobot()->getObjectId());
 	}
 	/**
 	 *
@@ -89,6 +92,9 @@ namespace View
 		drawPath( dc);
 
 		drawRobot( dc);
+
+		drawnArea = getBoundingBox();
+		drawnRouteArea = getRouteArea();
 	}
 	/**
 	 *
@@ -106,6 +112,78 @@ namespace View
 		getRobot()->setPosition( aPoint, false);
 		RectangleShape::setCentre( getRobot()->getPosition());
 	}
+	/**
+	 *
+	 */
+	void RobotShape::followRobot()
+	{
+		RectangleShape::setCentre( getRobot()->getPosition());
+	}
+	/**
+	 *
+	 */
+	wxRect RobotShape::getBoundingBox() const
+	{
+		Model::RobotPtr robot = getRobot();
+
+		wxRect area( centre, wxSize( 1, 1));
+		for (const wxPoint& corner : { robot->getFrontRight(), robot->getFrontLeft(), robot->getBackLeft(), robot->getBackRight() })
+		{
+			area.Union( wxRect( corner, wxSize( 1, 1)));
+		}
+		// The nose and the rotated title stay within this square around the centre
+		int radius = std::max( 25, std::max( titleSize.x, titleSize.y)); // @suppress("Avoid magic numbers")
+		area.Union( wxRect( centre.x - radius, centre.y - radius, 2 * radius + 1, 2 * radius + 1));
+		area.Union( wxRect( robot->startPosition.x - 3, robot->startPosition.y - 3, 7, 7)); // @suppress("Avoid magic numbers")
+
+		// The widest pen that is used
+		return area.Inflate( borderWidth + 5); // @suppress("Avoid magic numbers")
+	}
+	/**
+	 *
+	 */
+	bool RobotShape::followRoute()
+	{
+		Model::RobotPtr robot = getRobot();
+
+		// Read before the copies, a route that changes while copying is copied again next time
+		unsigned long version = robot->getRouteVersion();
+		if (version == routeVersion)
+		{
+			return false;
+		}
+		routeVersion = version;
+		path = robot->getPath();
+		openSet = robot->getOpenSet();
+
+		pathArea = wxRect();
+		for (const PathAlgorithm::Vertex& vertex : path)
+		{
+			pathArea.Union( wxRect( vertex.asPoint(), wxSize( 1, 1)));
+		}
+		openSetArea = wxRect();
+		for (const PathAlgorithm::Vertex& vertex : openSet)
+		{
+			openSetArea.Union( wxRect( vertex.asPoint(), wxSize( 1, 1)));
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	wxRect RobotShape::getRouteArea() const
+	{
+		wxRect area = pathArea;
+		if (Application::MainApplication::getSettings().getDrawOpenSet())
+		{
+			area.Union( openSetArea);
+		}
+		if (area.IsEmpty())
+		{
+			return area;
+		}
+		return area.Inflate( borderWidth);
+	}
 	/**
 	 *
 	 */
@@ -145,8 +223,12 @@ namespace View
 	 */
 	void RobotShape::updateSizeToTitle( wxDC& dc)
 	{
-		// The minimum size of the RectangleShape is the size of the title
-		titleSize = dc.GetTextExtent( title);
+		// The minimum size of the RectangleShape is the size of the title, which only has to be measured if it changed
+		if (title != measuredTitle)
+		{
+			titleSize = dc.GetTextExtent( title);
+			measuredTitle = title;
+		}
 		if (size.x < (titleSize.x + 2 * spacing + 2 * borderWidth))
 		{
 			size.x = titleSize.x + 2 * spacing + 2 * borderWidth;
@@ -174,7 +256,6 @@ namespace View
 	 */
 	void RobotShape::drawOpenSet( wxDC& dc)
 	{
-		PathAlgorithm::OpenSet openSet = getRobot()->getOpenSet();
 		if (openSet.size() != 0)
 		{
 			dc.SetPen( wxPen( "PALE GREEN", borderWidth, wxPENSTYLE_SOLID));
@@ -189,7 +270,6 @@ namespace View
 	 */
 	void RobotShape::drawPath( wxDC& dc)
 	{
-		PathAlgorithm::Path path = getRobot()->getPath();
 		if (path.size() != 0)
 		{
 			dc.SetPen( wxPen(  "BLACK", borderWidth, wxPENSTYLE_SOLID));
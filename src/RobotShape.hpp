@@ -118,6 +118,40 @@ namespace View
 			{
 				robotWorldCanvas = aRobotWorldCanvas;
 			}
+			/**
+			 * Moves the shape to the current position of the robot without writing the position
+			 * back to the robot, which may be moved concurrently by the SimulationScheduler.
+			 */
+			void followRobot();
+			/**
+			 * Copies the path and open set of the robot if they changed since the last call. Only
+			 * called by the canvas when it decides what to repaint, draw() uses the copies.
+			 *
+			 * @return true if they changed
+			 */
+			bool followRoute();
+			/**
+			 * The area the robot, its title and start position cover if they are drawn now
+			 */
+			wxRect getBoundingBox() const;
+			/**
+			 * The area the robot, its title and start position covered the last time they were drawn
+			 */
+			wxRect getDrawnArea() const
+			{
+				return drawnArea;
+			}
+			/**
+			 * The area the path and, if drawn, the open set cover since the last followRoute()
+			 */
+			wxRect getRouteArea() const;
+			/**
+			 * The area the path and open set covered the last time they were drawn
+			 */
+			wxRect getDrawnRouteArea() const
+			{
+				return drawnRouteArea;
+			}
 		protected:
 
 		private:
@@ -125,6 +159,26 @@ namespace View
 			 *
 			 */
 			RobotWorldCanvas* robotWorldCanvas;
+			/**
+			 * The title titleSize was measured for, the text extent is only measured again if the title changed
+			 */
+			std::string measuredTitle;
+			/**
+			 *
+			 */
+			wxRect drawnArea;
+			/**
+			 * The route of the robot as of routeVersion, only copied and measured again if it changed
+			 */
+			unsigned long routeVersion;
+			PathAlgorithm::Path path;
+			PathAlgorithm::OpenSet openSet;
+			wxRect pathArea;
+			wxRect openSetArea;
+			/**
+			 *
+			 */
+			wxRect drawnRouteArea;
 			/**
 			 *
 			 */
@@ -9,6 +9,77 @@
 #include <algorithm>
 
 namespace Model {
+namespace {
+/**
+ * Adds anObject to the indexes, a name that is already indexed keeps its object
+ */
+template<typename T>
+void AddToIndexes(const std::shared_ptr<T> &anObject,
+		std::unordered_map<Base::SymbolId, std::shared_ptr<T>> &aNameIndex,
+		std::unordered_map<Base::ObjectId, std::shared_ptr<T>> &anIdIndex) {
+	aNameIndex.emplace(anObject->getNameId(), anObject);
+	anIdIndex.emplace(anObject->getObjectId(), anObject);
+}
+/**
+ * Removes the name anObject was indexed with, the next object in anObjects
+ * with the same name takes over
+ */
+template<typename T>
+void RemoveFromNameIndex(const std::shared_ptr<T> &anObject,
+		Base::SymbolId aName, const std::vector<std::shared_ptr<T>> &anObjects,
+		std::unordered_map<Base::SymbolId, std::shared_ptr<T>> &aNameIndex) {
+	auto i = aNameIndex.find(aName);
+	if (i == aNameIndex.end() || i->second != anObject) {
+		return;
+	}
+	aNameIndex.erase(i);
+	auto j = std::find_if(anObjects.begin(), anObjects.end(),
+			[&anObject, aName](const std::shared_ptr<T> &object) {
+				return object != anObject && object->getNameId() == aName;
+			});
+	if (j != anObjects.end()) {
+		aNameIndex.emplace(aName, *j);
+	}
+}
+/**
+ *
+ */
+template<typename K, typename T>
+std::shared_ptr<T> FindInIndex(
+		const std::unordered_map<K, std::shared_ptr<T>> &anIndex,
+		const K &aKey) {
+	auto i = anIndex.find(aKey);
+	if (i != anIndex.end()) {
+		return i->second;
+	}
+	return nullptr;
+}
+/**
+ *
+ */
+void RebuildIndexes(WorldSnapshot &aWorld) {
+	aWorld.robotsByName.clear();
+	aWorld.robotsById.clear();
+	aWorld.wayPointsByName.clear();
+	aWorld.wayPointsById.clear();
+	aWorld.goalsByName.clear();
+	aWorld.goalsById.clear();
+	aWorld.wallsById.clear();
+
+	for (RobotPtr robot : aWorld.robots) {
+		AddToIndexes(robot, aWorld.robotsByName, aWorld.robotsById);
+	}
+	for (WayPointPtr wayPoint : aWorld.wayPoints) {
+		AddToIndexes(wayPoint, aWorld.wayPointsByName, aWorld.wayPointsById);
+	}
+	for (GoalPtr goal : aWorld.goals) {
+		AddToIndexes(goal, aWorld.goalsByName, aWorld.goalsById);
+	}
+	for (WallPtr wall : aWorld.walls) {
+		aWorld.wallsById.emplace(wall->getObjectId(), wall);
+	}
+}
+} // namespace
 /**
  *
  */
@@ -23,7 +94,14 @@ RobotPtr RobotWorld::newRobot(const std::string &aName /*= "New Robot"*/,
 		const wxPoint &aPosition /*= wxPoint(-1,-1)*/,
 		bool aNotifyObservers /*= true*/) {
 	RobotPtr robot = std::make_shared<Robot>(aName, aPosition);
-	robots.push_back(robot);
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		std::shared_ptr<WorldSnapshot> world = copySnapshot();
+		world->robots.push_back(robot);
+		recordChange(WorldChange::Added, robot);
+		AddToIndexes(robot, world->robotsByName, world->robotsById);
+		publish(world);
+	}
 	if (aNotifyObservers == true) {
 		notifyObservers();
 	}
@@ -37,7 +115,14 @@ WayPointPtr RobotWorld::newWayPoint(
 		const wxPoint &aPosition /*= wxPoint(-1,-1)*/,
 		bool aNotifyObservers /*= true*/) {
 	WayPointPtr wayPoint(new WayPoint(aName, aPosition));
-	wayPoints.push_back(wayPoint);
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		std::shared_ptr<WorldSnapshot> world = copySnapshot();
+		world->wayPoints.push_back(wayPoint);
+		recordChange(WorldChange::Added, wayPoint);
+		AddToIndexes(wayPoint, world->wayPointsByName, world->wayPointsById);
+		publish(world);
+	}
 	if (aNotifyObservers == true) {
 		notifyObservers();
 	}
@@ -50,7 +135,14 @@ GoalPtr RobotWorld::newGoal(const std::string &aName /*= "New Goal"*/,
 		const wxPoint &aPosition /*= wxPoint(-1,-1)*/,
 		bool aNotifyObservers /*= true*/) {
 	GoalPtr goal = std::make_shared<Goal>(aName, aPosition);
-	goals.push_back(goal);
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		std::shared_ptr<WorldSnapshot> world = copySnapshot();
+		world->goals.push_back(goal);
+		recordChange(WorldChange::Added, goal);
+		AddToIndexes(goal, world->goalsByName, world->goalsById);
+		publish(world);
+	}
 	if (aNotifyObservers == true) {
 		notifyObservers();
 	}
@@ -62,7 +154,14 @@ GoalPtr RobotWorld::newGoal(const std::string &aName /*= "New Goal"*/,
 WallPtr RobotWorld::newWall(const wxPoint &aPoint1, const wxPoint &aPoint2,
 		bool aNotifyObservers /*= true*/) {
 	WallPtr wall = std::make_shared<Wall>(aPoint1, aPoint2);
-	walls.push_back(wall);
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		std::shared_ptr<WorldSnapshot> world = copySnapshot();
+		world->walls.push_back(wall);
+		world->wallsById.emplace(wall->getObjectId(), wall);
+		recordChange(WorldChange::Added, wall);
+		publish(world);
+	}
 	if (aNotifyObservers == true) {
 		notifyObservers();
 	}
@@ -73,14 +172,26 @@ WallPtr RobotWorld::newWall(const wxPoint &aPoint1, const wxPoint &aPoint2,
  */
 void RobotWorld::deleteRobot(RobotPtr aRobot,
 		bool aNotifyObservers /*= true*/) {
-	auto i = std::find_if(robots.begin(), robots.end(), [aRobot](RobotPtr r) {
-		return aRobot->getName() == r->getName();
-	});
-	if (i != robots.end()) {
-		robots.erase(i);
-		if (aNotifyObservers == true) {
-			notifyObservers();
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		std::shared_ptr<WorldSnapshot> world = copySnapshot();
+		auto i = std::find_if(world->robots.begin(), world->robots.end(),
+				[aRobot](RobotPtr r) {
+					return aRobot->getNameId() == r->getNameId();
+				});
+		if (i == world->robots.end()) {
+			return;
 		}
+		RobotPtr robot = *i;
+		world->robots.erase(i);
+		world->robotsById.erase(robot->getObjectId());
+		recordChange(WorldChange::Removed, robot);
+		RemoveFromNameIndex(robot, robot->getNameId(), world->robots,
+				world->robotsByName);
+		publish(world);
+	}
+	if (aNotifyObservers == true) {
+		notifyObservers();
 	}
 }
 /**
@@ -88,164 +199,228 @@ void RobotWorld::deleteRobot(RobotPtr aRobot,
  */
 void RobotWorld::deleteWayPoint(WayPointPtr aWayPoint,
 		bool aNotifyObservers /*= true*/) {
-	auto i = std::find_if(wayPoints.begin(), wayPoints.end(),
-			[aWayPoint](WayPointPtr w) {
-				return aWayPoint->getName() == w->getName();
-			});
-	if (i != wayPoints.end()) {
-		wayPoints.erase(i);
-		if (aNotifyObservers == true) {
-			notifyObservers();
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		std::shared_ptr<WorldSnapshot> world = copySnapshot();
+		auto i = std::find_if(world->wayPoints.begin(), world->wayPoints.end(),
+				[aWayPoint](WayPointPtr w) {
+					return aWayPoint->getNameId() == w->getNameId();
+				});
+		if (i == world->wayPoints.end()) {
+			return;
 		}
+		WayPointPtr wayPoint = *i;
+		world->wayPoints.erase(i);
+		world->wayPointsById.erase(wayPoint->getObjectId());
+		recordChange(WorldChange::Removed, wayPoint);
+		RemoveFromNameIndex(wayPoint, wayPoint->getNameId(), world->wayPoints,
+				world->wayPointsByName);
+		publish(world);
+	}
+	if (aNotifyObservers == true) {
+		notifyObservers();
 	}
 }
 /**
  *
  */
 void RobotWorld::deleteGoal(GoalPtr aGoal, bool aNotifyObservers /*= true*/) {
-	auto i = std::find_if(goals.begin(), goals.end(), [aGoal](GoalPtr g) {
-		return aGoal->getName() == g->getName();
-	});
-	if (i != goals.end()) {
-		goals.erase(i);
-
-		if (aNotifyObservers == true) {
-			notifyObservers();
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		std::shared_ptr<WorldSnapshot> world = copySnapshot();
+		auto i = std::find_if(world->goals.begin(), world->goals.end(),
+				[aGoal](GoalPtr g) {
+					return aGoal->getNameId() == g->getNameId();
+				});
+		if (i == world->goals.end()) {
+			return;
 		}
+		GoalPtr goal = *i;
+		world->goals.erase(i);
+		world->goalsById.erase(goal->getObjectId());
+		recordChange(WorldChange::Removed, goal);
+		RemoveFromNameIndex(goal, goal->getNameId(), world->goals,
+				world->goalsByName);
+		publish(world);
+	}
+	if (aNotifyObservers == true) {
+		notifyObservers();
 	}
 }
 /**
  *
  */
 void RobotWorld::deleteWall(WallPtr aWall, bool aNotifyObservers /*= true*/) {
-	auto i = std::find_if(walls.begin(), walls.end(),
-			[aWall](WallPtr w) {
-				return aWall->getPoint1() == w->getPoint1()
-						&& aWall->getPoint2() == w->getPoint2();
-			});
-	if (i != walls.end()) {
-		walls.erase(i);
-
-		if (aNotifyObservers == true) {
-			notifyObservers();
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		std::shared_ptr<WorldSnapshot> world = copySnapshot();
+		auto i = std::find_if(world->walls.begin(), world->walls.end(),
+				[aWall](WallPtr w) {
+					return aWall->getPoint1() == w->getPoint1()
+							&& aWall->getPoint2() == w->getPoint2();
+				});
+		if (i == world->walls.end()) {
+			return;
 		}
+		recordChange(WorldChange::Removed, *i);
+		world->wallsById.erase((*i)->getObjectId());
+		world->walls.erase(i);
+		publish(world);
+	}
+	if (aNotifyObservers == true) {
+		notifyObservers();
 	}
 }
 /**
  *
  */
 RobotPtr RobotWorld::getRobot(const std::string &aName) const {
-	if (auto i = std::find_if(robots.begin(), robots.end(),
-			[&aName](RobotPtr robot) {
-				return robot->getName() == aName;
-			}); i != robots.end()) {
-		return *i;
+	Base::SymbolId name;
+	if (!Base::SymbolTable::find(aName, name)) {
+		return nullptr;
 	}
-	return nullptr;
+	return getRobot(name);
+}
+/**
+ *
+ */
+RobotPtr RobotWorld::getRobot(Base::SymbolId aName) const {
+	return FindInIndex(getSnapshot()->robotsByName, aName);
 }
 /**
  *
  */
 RobotPtr RobotWorld::getRobot(const Base::ObjectId &anObjectId) const {
-	if (auto i = std::find_if(robots.begin(), robots.end(),
-			[&anObjectId](RobotPtr robot) {
-				return robot->getObjectId() == anObjectId;
-			}); i != robots.end()) {
-		return *i;
-	}
-	return nullptr;
+	return FindInIndex(getSnapshot()->robotsById, anObjectId);
 }
 /**
  *
  */
 WayPointPtr RobotWorld::getWayPoint(const std::string &aName) const {
-	if (auto i = std::find_if(wayPoints.begin(), wayPoints.end(),
-			[&aName](WayPointPtr wayPoint) {
-				return wayPoint->getName() == aName;
-			}); i != wayPoints.end()) {
-		return *i;
+	Base::SymbolId name;
+	if (!Base::SymbolTable::find(aName, name)) {
+		return nullptr;
 	}
-	return nullptr;
+	return getWayPoint(name);
+}
+/**
+ *
+ */
+WayPointPtr RobotWorld::getWayPoint(Base::SymbolId aName) const {
+	return FindInIndex(getSnapshot()->wayPointsByName, aName);
 }
 /**
  *
  */
 WayPointPtr RobotWorld::getWayPoint(const Base::ObjectId &anObjectId) const {
-	if (auto i = std::find_if(wayPoints.begin(), wayPoints.end(),
-			[&anObjectId](WayPointPtr wayPoint) {
-				return wayPoint->getObjectId() == anObjectId;
-			}); i != wayPoints.end()) {
-		return *i;
-	}
-	return nullptr;
+	return FindInIndex(getSnapshot()->wayPointsById, anObjectId);
 }
 /**
  *
  */
 GoalPtr RobotWorld::getGoal(const std::string &aName) const {
-	if (auto i = std::find_if(goals.begin(), goals.end(),
-			[&aName](GoalPtr goal) {
-				return goal->getName() == aName;
-			}); i != goals.end()) {
-		return *i;
+	Base::SymbolId name;
+	if (!Base::SymbolTable::find(aName, name)) {
+		return nullptr;
 	}
-	return nullptr;
+	return getGoal(name);
+}
+/**
+ *
+ */
+GoalPtr RobotWorld::getGoal(Base::SymbolId aName) const {
+	return FindInIndex(getSnapshot()->goalsByName, aName);
 }
 /**
  *
  */
 GoalPtr RobotWorld::getGoal(const Base::ObjectId &anObjectId) const {
-	if (auto i = std::find_if(goals.begin(), goals.end(),
-			[&anObjectId](GoalPtr goal) {
-				return goal->getObjectId() == anObjectId;
-			}); i != goals.end()) {
-		return *i;
-	}
-	return nullptr;
+	return FindInIndex(getSnapshot()->goalsById, anObjectId);
 }
 /**
  *
  */
 WallPtr RobotWorld::getWall(const Base::ObjectId &anObjectId) const {
-	if (auto i = std::find_if(walls.begin(), walls.end(),
-			[&anObjectId](WallPtr wall) {
-				return wall->getObjectId() == anObjectId;
-			}); i != walls.end()) {
-		return *i;
-	}
-	return nullptr;
+	return FindInIndex(getSnapshot()->wallsById, anObjectId);
 }
 
 /**
  *
  */
-const std::vector<RobotPtr>& RobotWorld::getRobots() const {
-	return robots;
+void RobotWorld::updateNameIndex(const Base::ObjectId &anObjectId,
+		Base::SymbolId anOldName, Base::SymbolId aNewName) {
+	std::lock_guard<std::mutex> lock(writeMutex);
+	std::shared_ptr<WorldSnapshot> world = copySnapshot();
+	if (RobotPtr robot = FindInIndex(world->robotsById, anObjectId)) {
+		RemoveFromNameIndex(robot, anOldName, world->robots,
+				world->robotsByName);
+		world->robotsByName.emplace(aNewName, robot);
+	}
+	if (WayPointPtr wayPoint = FindInIndex(world->wayPointsById, anObjectId)) {
+		RemoveFromNameIndex(wayPoint, anOldName, world->wayPoints,
+				world->wayPointsByName);
+		world->wayPointsByName.emplace(aNewName, wayPoint);
+	}
+	if (GoalPtr goal = FindInIndex(world->goalsById, anObjectId)) {
+		RemoveFromNameIndex(goal, anOldName, world->goals, world->goalsByName);
+		world->goalsByName.emplace(aNewName, goal);
+	}
+	publish(world);
 }
 /**
  *
  */
-const std::vector<WayPointPtr>& RobotWorld::getWayPoints() const {
-	return wayPoints;
+WorldSnapshotPtr RobotWorld::getSnapshot() const {
+	return std::atomic_load(&snapshot);
 }
 /**
  *
  */
-const std::vector<GoalPtr>& RobotWorld::getGoals() const {
-	return goals;
+bool RobotWorld::getChangesSince(unsigned long long &aVersion,
+		std::vector<WorldChange> &aChanges) const {
+	std::lock_guard<std::mutex> lock(changesBusy);
+	bool complete = aVersion >= forgottenVersion;
+	// The changes are ordered by version, skip the ones the caller has seen
+	auto i = std::upper_bound(changes.begin(), changes.end(), aVersion,
+			[](unsigned long long aSeenVersion, const WorldChange &aChange) {
+				return aSeenVersion < aChange.version;
+			});
+	aChanges.insert(aChanges.end(), i, changes.end());
+	if (!changes.empty() && changes.back().version > aVersion) {
+		aVersion = changes.back().version;
+	}
+	return complete;
 }
 /**
  *
  */
-const std::vector<WallPtr>& RobotWorld::getWalls() const {
-	return walls;
+std::vector<RobotPtr> RobotWorld::getRobots() const {
+	return getSnapshot()->robots;
+}
+/**
+ *
+ */
+std::vector<WayPointPtr> RobotWorld::getWayPoints() const {
+	return getSnapshot()->wayPoints;
+}
+/**
+ *
+ */
+std::vector<GoalPtr> RobotWorld::getGoals() const {
+	return getSnapshot()->goals;
+}
+/**
+ *
+ */
+std::vector<WallPtr> RobotWorld::getWalls() const {
+	return getSnapshot()->walls;
 }
 /**
  *
  */
 void RobotWorld::populate(unsigned short worldNumber) {
 	std::ostringstream os;
-	os << "Robots vector size: " << robots.size();
+	os << "Robots vector size: " << getSnapshot()->robots.size();
 	Application::Logger::log(os.str());
 	switch (worldNumber) {
 	case 0:
@@ -447,10 +622,24 @@ void RobotWorld::generateWorld8() {
  *
  */
 void RobotWorld::unpopulate(bool aNotifyObservers /*= true*/) {
-	robots.clear();
-	wayPoints.clear();
-	goals.clear();
-	walls.clear();
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		for (RobotPtr robot : snapshot->robots) {
+			recordChange(WorldChange::Removed, robot);
+		}
+		for (WayPointPtr wayPoint : snapshot->wayPoints) {
+			recordChange(WorldChange::Removed, wayPoint);
+		}
+		for (GoalPtr goal : snapshot->goals) {
+			recordChange(WorldChange::Removed, goal);
+		}
+		for (WallPtr wall : snapshot->walls) {
+			recordChange(WorldChange::Removed, wall);
+		}
+		std::shared_ptr<WorldSnapshot> world = std::make_shared<WorldSnapshot>();
+		world->version = snapshot->version;
+		publish(world);
+	}
 
 	if (aNotifyObservers) {
 		notifyObservers();
@@ -461,46 +650,76 @@ void RobotWorld::unpopulate(bool aNotifyObservers /*= true*/) {
  */
 void RobotWorld::unpopulate(const std::vector<Base::ObjectId> &aKeepObjects,
 		bool aNotifyObservers /*= true*/) {
-	if (robots.size() > 0) {
-		robots.erase(
-				std::remove_if(robots.begin(), robots.end(),
-						[&aKeepObjects](RobotPtr aRobot) {
-							return std::find(aKeepObjects.begin(),
-									aKeepObjects.end(), aRobot->getObjectId())
-									== aKeepObjects.end();
-						}),
-				robots.end());
-	}
-	if (wayPoints.size() > 0) {
-		wayPoints.erase(
-				std::remove_if(wayPoints.begin(), wayPoints.end(),
-						[&aKeepObjects](WayPointPtr aWayPoint) {
-							return std::find(aKeepObjects.begin(),
-									aKeepObjects.end(),
-									aWayPoint->getObjectId())
-									== aKeepObjects.end();
-						}),
-				wayPoints.end());
-	}
-	if (goals.size() > 0) {
-		goals.erase(
-				std::remove_if(goals.begin(), goals.end(),
-						[&aKeepObjects](GoalPtr aGoal) {
-							return std::find(aKeepObjects.begin(),
-									aKeepObjects.end(), aGoal->getObjectId())
-									== aKeepObjects.end();
-						}),
-				goals.end());
-	}
-	if (walls.size() > 0) {
-		walls.erase(
-				std::remove_if(walls.begin(), walls.end(),
-						[&aKeepObjects](WallPtr aWall) {
-							return std::find(aKeepObjects.begin(),
-									aKeepObjects.end(), aWall->getObjectId())
-									== aKeepObjects.end();
-						}),
-				walls.end());
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		std::shared_ptr<WorldSnapshot> world = copySnapshot();
+		std::vector<RobotPtr> &robots = world->robots;
+		std::vector<WayPointPtr> &wayPoints = world->wayPoints;
+		std::vector<GoalPtr> &goals = world->goals;
+		std::vector<WallPtr> &walls = world->walls;
+		if (robots.size() > 0) {
+			robots.erase(
+					std::remove_if(robots.begin(), robots.end(),
+							[&aKeepObjects](RobotPtr aRobot) {
+								return std::find(aKeepObjects.begin(),
+										aKeepObjects.end(), aRobot->getObjectId())
+										== aKeepObjects.end();
+							}),
+					robots.end());
+		}
+		if (wayPoints.size() > 0) {
+			wayPoints.erase(
+					std::remove_if(wayPoints.begin(), wayPoints.end(),
+							[&aKeepObjects](WayPointPtr aWayPoint) {
+								return std::find(aKeepObjects.begin(),
+										aKeepObjects.end(),
+										aWayPoint->getObjectId())
+										== aKeepObjects.end();
+							}),
+					wayPoints.end());
+		}
+		if (goals.size() > 0) {
+			goals.erase(
+					std::remove_if(goals.begin(), goals.end(),
+							[&aKeepObjects](GoalPtr aGoal) {
+								return std::find(aKeepObjects.begin(),
+										aKeepObjects.end(), aGoal->getObjectId())
+										== aKeepObjects.end();
+							}),
+					goals.end());
+		}
+		if (walls.size() > 0) {
+			walls.erase(
+					std::remove_if(walls.begin(), walls.end(),
+							[&aKeepObjects](WallPtr aWall) {
+								return std::find(aKeepObjects.begin(),
+										aKeepObjects.end(), aWall->getObjectId())
+										== aKeepObjects.end();
+							}),
+					walls.end());
+		}
+		RebuildIndexes(*world);
+		for (RobotPtr robot : snapshot->robots) {
+			if (!world->robotsById.count(robot->getObjectId())) {
+				recordChange(WorldChange::Removed, robot);
+			}
+		}
+		for (WayPointPtr wayPoint : snapshot->wayPoints) {
+			if (!world->wayPointsById.count(wayPoint->getObjectId())) {
+				recordChange(WorldChange::Removed, wayPoint);
+			}
+		}
+		for (GoalPtr goal : snapshot->goals) {
+			if (!world->goalsById.count(goal->getObjectId())) {
+				recordChange(WorldChange::Removed, goal);
+			}
+		}
+		for (WallPtr wall : snapshot->walls) {
+			if (!world->wallsById.count(wall->getObjectId())) {
+				recordChange(WorldChange::Removed, wall);
+			}
+		}
+		publish(world);
 	}
 
 	if (aNotifyObservers) {
@@ -508,25 +727,26 @@ void RobotWorld::unpopulate(const std::vector<Base::ObjectId> &aKeepObjects,
 	}
 }
 std::string RobotWorld::asCode() const {
+	WorldSnapshotPtr world = getSnapshot();
 	std::ostringstream os;
 	os << "\n\n";
-	for (RobotPtr ptr : robots) {
+	for (RobotPtr ptr : world->robots) {
 		os << "RobotWorld::getRobotWorld().newRobot( \"" << ptr->getName()
 				<< "\", wxPoint(" << ptr->getPosition().x << ","
 				<< ptr->getPosition().y << "),false);\n";
 	}
-	for (WallPtr ptr : walls) {
+	for (WallPtr ptr : world->walls) {
 		os << "RobotWorld::getRobotWorld().newWall( " << "wxPoint("
 				<< ptr->getPoint1().x << "," << ptr->getPoint1().y << "),"
 				<< "wxPoint(" << ptr->getPoint2().x << "," << ptr->getPoint2().y
 				<< "),false);\n";
 	}
-	for (WayPointPtr ptr : wayPoints) {
+	for (WayPointPtr ptr : world->wayPoints) {
 		os << "RobotWorld::getRobotWorld().newWayPoint( \"" << ptr->getName()
 				<< "\", wxPoint(" << ptr->getPosition().x << ","
 				<< ptr->getPosition().y << "),false);\n";
 	}
-	for (GoalPtr ptr : goals) {
+	for (GoalPtr ptr : world->goals) {
 		os << "RobotWorld::getRobotWorld().newGoal( \"" << ptr->getName()
 				<< "\", wxPoint(" << ptr->getPosition().x << ","
 				<< ptr->getPosition().y << "),false);\n";
@@ -548,16 +768,18 @@ std::string RobotWorld::asDebugString() const {
 
 	os << asString() << '\n';
 
-	for (RobotPtr ptr : robots) {
+	WorldSnapshotPtr world = getSnapshot();
+
+	for (RobotPtr ptr : world->robots) {
 		os << ptr->asDebugString() << '\n';
 	}
-	for (WayPointPtr ptr : wayPoints) {
+	for (WayPointPtr ptr : world->wayPoints) {
 		os << ptr->asDebugString() << '\n';
 	}
-	for (GoalPtr ptr : goals) {
+	for (GoalPtr ptr : world->goals) {
 		os << ptr->asDebugString() << '\n';
 	}
-	for (WallPtr ptr : walls) {
+	for (WallPtr ptr : world->walls) {
 		os << ptr->asDebugString() << '\n';
 	}
 
@@ -572,6 +794,40 @@ RobotWorld::~RobotWorld() {
 	unpopulate();
 }
 
+/**
+ *
+ */
+RobotWorld::RobotWorld() :
+		snapshot(std::make_shared<WorldSnapshot>()), forgottenVersion(0) {
+}
+/**
+ *
+ */
+std::shared_ptr<WorldSnapshot> RobotWorld::copySnapshot() const {
+	return std::make_shared<WorldSnapshot>(*snapshot);
+}
+/**
+ *
+ */
+void RobotWorld::publish(std::shared_ptr<WorldSnapshot> aSnapshot) {
+	++aSnapshot->version;
+	std::atomic_store(&snapshot,
+			std::static_pointer_cast<const WorldSnapshot>(aSnapshot));
+}
+
+/**
+ *
+ */
+void RobotWorld::recordChange(WorldChange::Kind aKind,
+		ModelObjectPtr anObject) {
+	std::lock_guard<std::mutex> lock(changesBusy);
+	changes.push_back(WorldChange { aKind, anObject, snapshot->version + 1 });
+	if (changes.size() > MaxNumberOfChanges) {
+		forgottenVersion = changes.front().version;
+		changes.pop_front();
+	}
+}
+
 void RobotWorld::merge() {
 	Application::Logger::log("we fucking merge");
 }
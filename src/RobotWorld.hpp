@@ -4,8 +4,13 @@
 #include "Config.hpp"
 
 #include "ModelObject.hpp"
+#include "SymbolTable.hpp"
 #include "Widgets.hpp"
 
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace Model
@@ -25,6 +30,75 @@ namespace Model
 	class RobotWorld;
 	typedef std::shared_ptr<RobotWorld> RobotWorldPtr;
 
+	/**
+	 * An immutable version of the contents of the RobotWorld. A writer copies the current
+	 * snapshot, changes the copy and publishes it as the next version, so a reader that holds
+	 * a snapshot sees a consistent world for as long as it likes.
+	 *
+	 * Neither side is free: RobotWorld::getSnapshot() is std::atomic_load on a shared_ptr, which
+	 * libstdc++ implements with a mutex from a small global pool, held while the pointer is copied.
+	 * Every change copies all vectors and indexes below. That suits a world that is read far more
+	 * often than objects are added or removed.
+	 *
+	 * The objects themselves are shared between the snapshots: a snapshot only pins which
+	 * objects are in the world, not e.g. the positions of the robots.
+	 */
+	struct WorldSnapshot
+	{
+			/**
+			 *
+			 */
+			unsigned long long version = 0;
+			/**
+			 *
+			 */
+			std::vector< RobotPtr > robots;
+			std::vector< WayPointPtr > wayPoints;
+			std::vector< GoalPtr > goals;
+			std::vector< WallPtr > walls;
+			/**
+			 * Hash indexes on the vectors above. If more objects have the same name the
+			 * name index holds the first one, as the linear searches did.
+			 */
+			std::unordered_map< Base::SymbolId, RobotPtr > robotsByName;
+			std::unordered_map< Base::ObjectId, RobotPtr > robotsById;
+			std::unordered_map< Base::SymbolId, WayPointPtr > wayPointsByName;
+			std::unordered_map< Base::ObjectId, WayPointPtr > wayPointsById;
+			std::unordered_map< Base::SymbolId, GoalPtr > goalsByName;
+			std::unordered_map< Base::ObjectId, GoalPtr > goalsById;
+			std::unordered_map< Base::ObjectId, WallPtr > wallsById;
+	};
+	typedef std::shared_ptr< const WorldSnapshot > WorldSnapshotPtr;
+
+	/**
+	 * An object that was added to or removed from the RobotWorld. Observers of the world
+	 * get the changes since the version they saw last with RobotWorld::getChangesSince().
+	 * Robots that move notify their own observers, they are not a change of the world.
+	 */
+	struct WorldChange
+	{
+			/**
+			 *
+			 */
+			enum Kind
+			{
+				Added,
+				Removed
+			};
+			/**
+			 *
+			 */
+			Kind kind;
+			/**
+			 * A Robot, WayPoint, Goal or Wall
+			 */
+			ModelObjectPtr object;
+			/**
+			 * The version of the world that has the change
+			 */
+			unsigned long long version;
+	};
+
 	/**
 	 *
 	 */
@@ -83,6 +157,10 @@ namespace Model
 			 *
 			 */
 			RobotPtr getRobot( const std::string& aName) const;
+			/**
+			 * O(1) lookup for code that interned the name beforehand
+			 */
+			RobotPtr getRobot( Base::SymbolId aName) const;
 			/**
 			 *
 			 */
@@ -91,6 +169,10 @@ namespace Model
 			 *
 			 */
 			WayPointPtr getWayPoint( const std::string& aName) const;
+			/**
+			 * O(1) lookup for code that interned the name beforehand
+			 */
+			WayPointPtr getWayPoint( Base::SymbolId aName) const;
 			/**
 			 *
 			 */
@@ -99,6 +181,10 @@ namespace Model
 			 *
 			 */
 			GoalPtr getGoal( const std::string& aName) const;
+			/**
+			 * O(1) lookup for code that interned the name beforehand
+			 */
+			GoalPtr getGoal( Base::SymbolId aName) const;
 			/**
 			 *
 			 */
@@ -108,21 +194,42 @@ namespace Model
 			 */
 			WallPtr getWall( const Base::ObjectId& anObjectId) const;
 			/**
+			 * Called by the named objects when they are renamed to keep the name indexes up to date
+			 */
+			void updateNameIndex(	const Base::ObjectId& anObjectId,
+									Base::SymbolId anOldName,
+									Base::SymbolId aNewName);
+			/**
+			 * Returns the current version of the world. Code that looks at the world more than once
+			 * in a pass (painting, planning, collision checks) should hold on to one snapshot for the
+			 * whole pass instead of calling the getters below repeatedly.
+			 */
+			WorldSnapshotPtr getSnapshot() const;
+			/**
+			 * Appends the changes of the versions after aVersion to aChanges, oldest first, and sets
+			 * aVersion to the version of the last change.
 			 *
+			 * @return false if the oldest changes were forgotten already, the caller then has to
+			 * 			compare itself with getSnapshot() instead
 			 */
-			const std::vector< RobotPtr >& getRobots() const;
+			bool getChangesSince(	unsigned long long& aVersion,
+									std::vector< WorldChange >& aChanges) const;
 			/**
 			 *
 			 */
-			const std::vector< WayPointPtr >& getWayPoints() const;
+			std::vector< RobotPtr > getRobots() const;
 			/**
 			 *
 			 */
-			const std::vector< GoalPtr >& getGoals() const;
+			std::vector< WayPointPtr > getWayPoints() const;
 			/**
 			 *
 			 */
-			const std::vector< WallPtr >& getWalls() const;
+			std::vector< GoalPtr > getGoals() const;
+			/**
+			 *
+			 */
+			std::vector< WallPtr > getWalls() const;
 			/**
 			 *
 			 */
@@ -164,7 +271,7 @@ namespace Model
 			/**
 			 *
 			 */
-			RobotWorld() = default;
+			RobotWorld();
 			/**
 			 *
 			 */
@@ -172,12 +279,40 @@ namespace Model
 
 		private:
 			/**
-			 * The vectors are mutable to allow for lazy instantiation
+			 * Copies the current snapshot, to be called with writeMutex locked
+			 */
+			std::shared_ptr< WorldSnapshot > copySnapshot() const;
+			/**
+			 * Makes aSnapshot the next version of the world, to be called with writeMutex locked
+			 */
+			void publish( std::shared_ptr< WorldSnapshot > aSnapshot);
+			/**
+			 * Records a change of the version that the next publish() creates, to be called with writeMutex locked
+			 */
+			void recordChange(	WorldChange::Kind aKind,
+								ModelObjectPtr anObject);
+			/**
+			 * Serialises the writers, readers do not take it
+			 */
+			std::mutex writeMutex;
+			/**
+			 * Only accessed through std::atomic_load and std::atomic_store. These are not lock-free,
+			 * see WorldSnapshot.
+			 */
+			WorldSnapshotPtr snapshot;
+			/**
+			 * The number of changes that is kept for observers that lag behind
+			 */
+			static constexpr std::size_t MaxNumberOfChanges = 4096;
+			/**
+			 *
+			 */
+			mutable std::mutex changesBusy;
+			std::deque< WorldChange > changes;
+			/**
+			 * The version of the last change that was dropped from changes
 			 */
-			mutable std::vector< RobotPtr > robots;
-			mutable std::vector< WayPointPtr > wayPoints;
-			mutable std::vector< GoalPtr > goals;
-			mutable std::vector< WallPtr > walls;
+			unsigned long long forgottenVersion;
 			// made the world generation functions private for reasons.
 			void generateWorld1();
 			void generateWorld2();
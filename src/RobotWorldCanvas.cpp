@@ -4,6 +4,7 @@
 #include "GoalShape.hpp"
 #include "LineShape.hpp"
 #include "Logger.hpp"
+#include "MainApplication.hpp"
 #include "NotificationEvent.hpp"
 #include "RectangleShape.hpp"
 #include "Robot.hpp"
@@ -44,6 +45,7 @@ namespace View
 	 */
 	RobotWorldCanvas::RobotWorldCanvas( wxWindow* anOwner) :
 								wxScrolledCanvas( anOwner, wxID_ANY,wxDefaultPosition, wxDefaultSize, wxBORDER),
+								worldVersion( 0),
 								popupPoint( wxDefaultPosition),
 								startActionPoint( wxDefaultPosition),
 								endActionPoint( wxDefaultPosition),
@@ -56,7 +58,8 @@ namespace View
 								selectionEnabled( false),
 								menuItemEnabled( false),
 								dandEnabled( true),
-								notificationHandler( nullptr)
+								notificationHandler( nullptr),
+								staticLayerValid( false)
 	{
 		// CppCheck gives a "virtualCallInConstructor" on initialise(). I don't know why.
 		// It cannot be suppressed by a "cppcheck-suppress virtualCallInConstructor" (10-4-2022)
@@ -71,6 +74,7 @@ namespace View
 
 									wxScrolledCanvas( anOwner, wxID_ANY),
 									ViewObject(aModelObject),
+									worldVersion( 0),
 									popupPoint( wxDefaultPosition),
 									startActionPoint( wxDefaultPosition),
 									endActionPoint( wxDefaultPosition),
@@ -83,7 +87,8 @@ namespace View
 									selectionEnabled( false),
 									menuItemEnabled( false),
 									dandEnabled( true),
-									notificationHandler( nullptr)
+									notificationHandler( nullptr),
+								staticLayerValid( false)
 	{
 		// CppCheck gives a "virtualCallInConstructor" on initialise(). I don't know why.
 		// It cannot be suppressed by a "cppcheck-suppress virtualCallInConstructor" (10-4-2022)
@@ -95,6 +100,7 @@ namespace View
 	RobotWorldCanvas::~RobotWorldCanvas()
 	{
 		shapes.clear();
+		shapeIndex.clear();
 
 		PopEventHandler();
 
@@ -424,7 +430,21 @@ namespace View
 	 */
 	void RobotWorldCanvas::handleNotification()
 	{
-		handleBackGroundNotification();
+		// Only the first change of a frame needs an event, the others are picked up by the same update
+		if (coalescer.worldChanged())
+		{
+			handleBackGroundNotification();
+		}
+	}
+	/**
+	 *
+	 */
+	void RobotWorldCanvas::handleNotification( const Base::ObjectId& anObjectId)
+	{
+		if (coalescer.objectChanged( anObjectId))
+		{
+			handleBackGroundNotification();
+		}
 	}
 	/**
 	 *
@@ -451,6 +471,7 @@ namespace View
 	void RobotWorldCanvas::unpopulate()
 	{
 		shapes.clear();
+		shapeIndex.clear();
 		Model::RobotWorld::getRobotWorld().unpopulate();
 	}
 
@@ -462,10 +483,16 @@ namespace View
 		notificationHandler = new Base::NotificationHandler< std::function< void( wxNotifyEvent&) > >( [this](wxNotifyEvent& anEvent){this->OnNotificationEvent(anEvent);});
 		PushEventHandler( notificationHandler);
 
+		coalescer.setFrameRate( static_cast< unsigned int >( Application::MainApplication::getSettings().getFrameRate()));
+		frameTimer.SetOwner( this);
+		Bind( wxEVT_TIMER, &RobotWorldCanvas::OnFrameTimer, this, frameTimer.GetId());
+
 		Bind( wxEVT_PAINT, &RobotWorldCanvas::OnPaint, this);
 		Bind( wxEVT_SIZE, &RobotWorldCanvas::OnSize, this);
 
 		SetBackgroundColour(  "WHITE");
+		// handlePaint() paints every pixel from the static layer, erasing first would only flicker
+		SetBackgroundStyle( wxBG_STYLE_PAINT);
 		SetFocus();
 
 		enableHandlePaint();
@@ -499,11 +526,21 @@ namespace View
 	 */
 	void RobotWorldCanvas::render( wxDC& dc)
 	{
+		if (!staticLayerValid)
+		{
+			renderStaticLayer();
+		}
+		if (staticLayer.IsOk())
+		{
+			dc.DrawBitmap( staticLayer, 0, 0);
+		}
+		// The robots move, they are drawn on top of the static layer every time
 		for (ShapePtr shape : shapes)
 		{
-			//		Logger::log("Drawing shape: " + shape->asString());
-			shape->draw( dc);
-			//		Logger::log("Done drawing shape: " + shape->asString());
+			if (std::dynamic_pointer_cast< RobotShape >( shape))
+			{
+				shape->draw( dc);
+			}
 		}
 		if (startActionShape != nullptr && actionStatus == DRAWING)
 		{
@@ -511,12 +548,51 @@ namespace View
 			dc.DrawLine( startActionShape->getCentre().x, startActionShape->getCentre().y, endActionPoint.x, endActionPoint.y);
 		}
 	}
+	/**
+	 *
+	 */
+	void RobotWorldCanvas::renderStaticLayer()
+	{
+		wxSize clientSize = GetClientSize();
+		if (clientSize.x <= 0 || clientSize.y <= 0)
+		{
+			return;
+		}
+		if (!staticLayer.IsOk() || staticLayer.GetSize() != clientSize)
+		{
+			staticLayer.Create( clientSize);
+		}
+
+		wxMemoryDC dc( staticLayer);
+		dc.SetBackground( wxBrush( GetBackgroundColour()));
+		dc.Clear();
+		for (ShapePtr shape : shapes)
+		{
+			if (!std::dynamic_pointer_cast< RobotShape >( shape))
+			{
+				shape->draw( dc);
+			}
+		}
+		dc.SelectObject( wxNullBitmap);
+
+		staticLayerValid = true;
+	}
+	/**
+	 *
+	 */
+	void RobotWorldCanvas::refreshAll()
+	{
+		staticLayerValid = false;
+		Refresh();
+	}
 	/**
 	 *
 	 */
 	void RobotWorldCanvas::handlePaint( wxPaintEvent& UNUSEDPARAM(event))
 	{
-		wxPaintDC dc( this);
+		// Draws into a buffer that is put on the screen in one go. Only the update region is
+		// copied, so a robot that moved only costs the area it left and the area it went to.
+		wxAutoBufferedPaintDC dc( this);
 		render( dc);
 	}
 	/**
@@ -524,6 +600,7 @@ namespace View
 	 */
 	void RobotWorldCanvas::handleSize( wxSizeEvent& event)
 	{
+		refreshAll();
 		event.Skip();
 	}
 	/**
@@ -573,7 +650,7 @@ namespace View
 			Application::Logger::log( "Nothing selected...");
 		}
 
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -626,7 +703,7 @@ namespace View
 		endActionShape = nullptr;
 		actionStatus = IDLE;
 
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -642,7 +719,7 @@ namespace View
 				shape->handleActivated();
 			}
 		}
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -681,7 +758,7 @@ namespace View
 		if (selectShapeAt( screenPoint))
 		{
 		}
-		Refresh();
+		refreshAll();
 
 	}
 	/**
@@ -761,12 +838,13 @@ namespace View
 				{
 					startActionShape->setCentre( event.GetPosition() + actionOffset);
 					endActionPoint = event.GetPosition();
-					Refresh();
+					refreshAll();
 					break;
 				}
 				case DRAWING:
 				{
 					endActionPoint = event.GetPosition();
+					// Only the rubber band line changed
 					Refresh();
 					break;
 				}
@@ -874,7 +952,7 @@ namespace View
 	{
 		RobotShapePtr robot = std::make_shared<RobotShape>( Model::RobotWorld::getRobotWorld().newRobot( "Butter", popupPoint));
 		addShape(robot);
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -892,7 +970,7 @@ namespace View
 				shape->getRobot()->setName( name);
 			}
 		}
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -904,7 +982,7 @@ namespace View
 		{
 			removeShape( shape);
 		}
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -913,7 +991,7 @@ namespace View
 	{
 		WayPointShapePtr wayPoint = std::make_shared<WayPointShape>( Model::RobotWorld::getRobotWorld().newWayPoint( "Joost", popupPoint));
 		addShape(wayPoint);
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -931,7 +1009,7 @@ namespace View
 				shape->getWayPoint()->setName( name);
 			}
 		}
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -943,7 +1021,7 @@ namespace View
 		{
 			removeShape( shape);
 		}
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -952,7 +1030,7 @@ namespace View
 	{
 		GoalShapePtr goal = std::make_shared<GoalShape>( Model::RobotWorld::getRobotWorld().newGoal( "Peanut", popupPoint));
 		addShape(goal);
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -970,7 +1048,7 @@ namespace View
 				shape->getGoal()->setName( name);
 			}
 		}
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -982,7 +1060,7 @@ namespace View
 		{
 			removeShape( shape);
 		}
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -998,8 +1076,9 @@ namespace View
 		shapes.push_back( wall);
 		shapes.push_back( start);
 		shapes.push_back( end);
+		shapeIndex[wall->getModelObject()->getObjectId()] = wall;
 
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -1018,7 +1097,7 @@ namespace View
 		{
 			removeShape( shape);
 		}
-		Refresh();
+		refreshAll();
 	}
 	/**
 	 *
@@ -1035,19 +1114,18 @@ namespace View
 	 */
 	void RobotWorldCanvas::handleNotification( wxNotifyEvent& UNUSEDPARAM(aNotifyEvent))
 	{
-		remove<Model::Robot,View::RobotShape>( Model::RobotWorld::getRobotWorld().getRobots());
-		add<Model::Robot,View::RobotShape>( Model::RobotWorld::getRobotWorld().getRobots());
-
-		remove<Model::WayPoint,View::WayPointShape>( Model::RobotWorld::getRobotWorld().getWayPoints());
-		add<Model::WayPoint,View::WayPointShape>( Model::RobotWorld::getRobotWorld().getWayPoints());
-
-		remove<Model::Goal,View::GoalShape>( Model::RobotWorld::getRobotWorld().getGoals());
-		add<Model::Goal,View::GoalShape>( Model::RobotWorld::getRobotWorld().getGoals());
-
-		remove<Model::Wall,View::WallShape>( Model::RobotWorld::getRobotWorld().getWalls());
-		add<Model::Wall,View::WallShape>( Model::RobotWorld::getRobotWorld().getWalls());
-
-		Refresh();
+		Base::NotificationCoalescer::FrameClock::duration delay = coalescer.getUpdateDelay();
+		if (delay > Base::NotificationCoalescer::FrameClock::duration::zero())
+		{
+			// Too early for the next frame, the timer does the update when it is due
+			if (!frameTimer.IsRunning())
+			{
+				long milliseconds = std::chrono::duration_cast< std::chrono::milliseconds >( delay).count();
+				frameTimer.StartOnce( static_cast< int >( std::max( 1L, milliseconds)));
+			}
+			return;
+		}
+		updateShapes();
 	}
 	/**
 	 *
@@ -1168,6 +1246,7 @@ namespace View
 		aRobotShape->setRobotWorldCanvas(this);
 		aRobotShape->handleNotificationsFor(*aRobotShape->getRobot());
 		shapes.push_back( std::dynamic_pointer_cast< Shape >( aRobotShape));
+		shapeIndex[aRobotShape->getModelObject()->getObjectId()] = aRobotShape;
 	}
 	/**
 	 *
@@ -1176,6 +1255,7 @@ namespace View
 	{
 		aGoalShape->handleNotificationsFor(*aGoalShape->getGoal());
 		shapes.push_back( std::dynamic_pointer_cast< Shape >( aGoalShape));
+		shapeIndex[aGoalShape->getModelObject()->getObjectId()] = aGoalShape;
 	}
 	/**
 	 *
@@ -1184,6 +1264,7 @@ namespace View
 	{
 		aWayPointShape->handleNotificationsFor(*aWayPointShape->getWayPoint());
 		shapes.push_back( std::dynamic_pointer_cast< Shape >( aWayPointShape));
+		shapeIndex[aWayPointShape->getModelObject()->getObjectId()] = aWayPointShape;
 	}
 	/**
 	 *
@@ -1201,6 +1282,7 @@ namespace View
 		shapes.push_back( start);
 		shapes.push_back( end);
 		shapes.push_back( aWallShape);
+		shapeIndex[aWallShape->getModelObject()->getObjectId()] = aWallShape;
 	}
 	/**
 	 *
@@ -1250,6 +1332,10 @@ namespace View
 		{
 			setSelectedShape( nullptr);
 		}
+		if (aShape->getModelObject())
+		{
+			shapeIndex.erase( aShape->getModelObject()->getObjectId());
+		}
 		shapes.erase( std::find_if( shapes.begin(),
 									shapes.end(),
 									[aShape](ShapePtr s)
@@ -1257,6 +1343,18 @@ namespace View
 										return aShape->getObjectId() == s->getObjectId();
 									}));
 	}
+	/**
+	 *
+	 */
+	ShapePtr RobotWorldCanvas::getShapeFor( const Base::ObjectId& anObjectId) const
+	{
+		auto i = shapeIndex.find( anObjectId);
+		if (i != shapeIndex.end())
+		{
+			return i->second;
+		}
+		return nullptr;
+	}
 	/**
 	 *
 	 */
@@ -1466,4 +1564,151 @@ namespace View
 	{
 		handleNotification(aNotifyEvent);
 	}
+	/**
+	 *
+	 */
+	void RobotWorldCanvas::OnFrameTimer( wxTimerEvent& UNUSEDPARAM(event))
+	{
+		updateShapes();
+	}
+	/**
+	 *
+	 */
+	void RobotWorldCanvas::updateShapes()
+	{
+		Base::NotificationCoalescer::Changes changes = coalescer.takeChanges();
+
+		if (changes.world)
+		{
+			std::vector< Model::WorldChange > worldChanges;
+			if (Model::RobotWorld::getRobotWorld().getChangesSince( worldVersion, worldChanges))
+			{
+				for (const Model::WorldChange& change : worldChanges)
+				{
+					applyWorldChange( change);
+				}
+			} else
+			{
+				synchroniseWithWorld();
+			}
+			// Walls, goals or way points may have come or gone
+			refreshAll();
+		}
+
+		// Only the robots that reported a change in this frame are moved, and only the area they
+		// were drawn in and the area they will be drawn in are repainted
+		for (const Base::ObjectId& objectId : changes.objects)
+		{
+			if (RobotShapePtr robotShape = std::dynamic_pointer_cast< RobotShape >( getShapeFor( objectId)))
+			{
+				robotShape->followRobot();
+				const bool routeChanged = robotShape->followRoute();
+				if (!changes.world)
+				{
+					wxRect dirtyArea = robotShape->getDrawnArea();
+					dirtyArea.Union( robotShape->getBoundingBox());
+					RefreshRect( dirtyArea, false);
+					// The path is only repainted as a whole when the robot got a new one
+					if (routeChanged)
+					{
+						for (const wxRect& routeArea : { robotShape->getDrawnRouteArea(), robotShape->getRouteArea() })
+						{
+							if (!routeArea.IsEmpty())
+							{
+								RefreshRect( routeArea, false);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void RobotWorldCanvas::applyWorldChange( const Model::WorldChange& aChange)
+	{
+		ShapePtr shape = getShapeFor( aChange.object->getObjectId());
+		if (aChange.kind == Model::WorldChange::Added)
+		{
+			if (shape)
+			{
+				return;
+			}
+			if (Model::RobotPtr robot = std::dynamic_pointer_cast< Model::Robot >( aChange.object))
+			{
+				addShape( std::make_shared< RobotShape >( robot));
+			} else if (Model::GoalPtr goal = std::dynamic_pointer_cast< Model::Goal >( aChange.object))
+			{
+				// A Goal is a WayPoint, so it has to be tried first
+				addShape( std::make_shared< GoalShape >( goal));
+			} else if (Model::WayPointPtr wayPoint = std::dynamic_pointer_cast< Model::WayPoint >( aChange.object))
+			{
+				addShape( std::make_shared< WayPointShape >( wayPoint));
+			} else if (Model::WallPtr wall = std::dynamic_pointer_cast< Model::Wall >( aChange.object))
+			{
+				addShape( std::make_shared< WallShape >( wall));
+			}
+		} else if (shape)
+		{
+			removeTypedShape( shape);
+		}
+	}
+	/**
+	 *
+	 */
+	void RobotWorldCanvas::removeTypedShape( ShapePtr aShape)
+	{
+		if (RobotShapePtr robotShape = std::dynamic_pointer_cast< RobotShape >( aShape))
+		{
+			removeShape( robotShape);
+		} else if (GoalShapePtr goalShape = std::dynamic_pointer_cast< GoalShape >( aShape))
+		{
+			// A GoalShape is a WayPointShape, so it has to be tried first
+			removeShape( goalShape);
+		} else if (WayPointShapePtr wayPointShape = std::dynamic_pointer_cast< WayPointShape >( aShape))
+		{
+			removeShape( wayPointShape);
+		} else if (WallShapePtr wallShape = std::dynamic_pointer_cast< WallShape >( aShape))
+		{
+			removeShape( wallShape);
+		}
+	}
+	/**
+	 *
+	 */
+	void RobotWorldCanvas::synchroniseWithWorld()
+	{
+		// Remove and add against the same version of the world, a robot thread may change it meanwhile
+		Model::WorldSnapshotPtr world = Model::RobotWorld::getRobotWorld().getSnapshot();
+		worldVersion = world->version;
+
+		std::vector< ShapePtr > removedShapes;
+		for (const auto& entry : shapeIndex)
+		{
+			const Base::ObjectId& objectId = entry.first;
+			if (world->robotsById.count( objectId) == 0 && world->wayPointsById.count( objectId) == 0 &&
+				world->goalsById.count( objectId) == 0 && world->wallsById.count( objectId) == 0)
+			{
+				removedShapes.push_back( entry.second);
+			}
+		}
+		for (ShapePtr shape : removedShapes)
+		{
+			removeTypedShape( shape);
+		}
+
+		add<Model::Robot,View::RobotShape>( world->robots);
+		add<Model::WayPoint,View::WayPointShape>( world->wayPoints);
+		add<Model::Goal,View::GoalShape>( world->goals);
+		add<Model::Wall,View::WallShape>( world->walls);
+
+		for (ShapePtr shape : shapes)
+		{
+			if (RobotShapePtr robotShape = std::dynamic_pointer_cast< RobotShape >(shape))
+			{
+				robotShape->followRobot();
+			}
+		}
+	}
 } // namespace View
@@ -3,12 +3,14 @@
 
 #include "Config.hpp"
 
+#include "NotificationCoalescer.hpp"
 #include "NotificationHandler.hpp"
 #include "RobotWorld.hpp"
 #include "Shape.hpp"
 #include "ViewObject.hpp"
 #include "Widgets.hpp"
 
+#include <unordered_map>
 #include <vector>
 
 namespace View
@@ -162,6 +164,11 @@ namespace View
 			 * handleNotification() is routed to this function as a convenience. Bad for performance though.
 			 */
 			virtual void handleBackGroundNotification();
+			/**
+			 * Called by the shapes, in the thread that changed their model object. Only records the change,
+			 * the canvas is updated at most once per frame with all the changes of that frame.
+			 */
+			void handleNotification( const Base::ObjectId& anObjectId);
 			/**
 			 * Asks the world to populates itself with a robot, a goal and the given number of walls
 			 */
@@ -176,9 +183,17 @@ namespace View
 			 */
 			void initialise();
 			/**
-			 *
+			 * Draws the static layer and the robots on top of it
 			 */
 			void render( wxDC& dc);
+			/**
+			 * Draws everything but the robots into staticLayer
+			 */
+			void renderStaticLayer();
+			/**
+			 * Repaints everything including the static layer, to be used after anything but a robot changed
+			 */
+			void refreshAll();
 			/**
 			 * @name Event handling functions
 			 *
@@ -275,6 +290,14 @@ namespace View
 			 *
 			 */
 			void removeGenericShape( ShapePtr aShape);
+			/**
+			 * Returns the Shape that looks at the ModelObject with anObjectId, if any
+			 */
+			ShapePtr getShapeFor( const Base::ObjectId& anObjectId) const;
+			/**
+			 * Calls the removeShape() that fits the type of aShape
+			 */
+			void removeTypedShape( ShapePtr aShape);
 		private:
 			/**
 			 * @name Event handlers
@@ -324,9 +347,31 @@ namespace View
 			void OnGenerateWorldCode( wxCommandEvent& event);
 
 			void OnNotificationEvent( wxNotifyEvent& aNotifyEvent);
+
+			void OnFrameTimer( wxTimerEvent& event);
 			//@}
+			/**
+			 * Brings the shapes up to date with the changes that were collected since the previous frame
+			 */
+			void updateShapes();
+			/**
+			 * Adds or removes the Shape of the object in aChange
+			 */
+			void applyWorldChange( const Model::WorldChange& aChange);
+			/**
+			 * Compares the shapes with the whole world, for when the world forgot the changes since worldVersion
+			 */
+			void synchroniseWithWorld();
 
 			std::vector< ShapePtr > shapes;
+			/**
+			 * The Shapes in shapes that look at a ModelObject, by the ObjectId of that ModelObject
+			 */
+			std::unordered_map< Base::ObjectId, ShapePtr > shapeIndex;
+			/**
+			 * The version of the RobotWorld the shapes are up to date with
+			 */
+			unsigned long long worldVersion;
 
 			enum
 			{
@@ -357,36 +402,20 @@ namespace View
 			bool dandEnabled;
 
 			Base::NotificationHandler< std::function< void( wxNotifyEvent&) > > * notificationHandler;
-
 			/**
-			 * This function removes all Shapes that look at a ModelObject that is not longer in RobotWorld
+			 * The changes of the model since the last update of the shapes
 			 */
-			template< typename T, typename S >
-			void remove( const std::vector<std::shared_ptr< T > >& aTs)
-			{
-				std::vector< ShapePtr> shapePtrs;
-				std::copy_if(	shapes.begin(),
-								shapes.end(),
-								std::back_inserter(shapePtrs),
-								[&aTs](ShapePtr aShape)
-								{
-									std::shared_ptr< S > shape = std::dynamic_pointer_cast< S >( aShape);
-									if (shape)
-									{
-										return std::find_if(	aTs.begin(),
-																aTs.end(),
-																[shape](std::shared_ptr< T > aT)
-																{
-																	return shape->getModelObject()->getObjectId() == aT->getObjectId();
-																}) == aTs.end();
-									}
-									return false;
-								});
-				for(ShapePtr shape : shapePtrs)
-				{
-					removeShape( std::dynamic_pointer_cast< S >( shape));
-				}
-			}
+			Base::NotificationCoalescer coalescer;
+			/**
+			 * Fires when the next frame is due if a change came in too early
+			 */
+			wxTimer frameTimer;
+			/**
+			 * Walls, goals and way points, drawn once and reused until one of them changes
+			 */
+			wxBitmap staticLayer;
+			bool staticLayerValid;
+
 			/**
 			 * This function add Shapes for ModelObjects that are in RobotWorld but that have no Shape yet
 			 */
@@ -395,17 +424,7 @@ namespace View
 			{
 				for(std::shared_ptr< T > t : aTs)
 				{
-					auto result = std::find_if(	shapes.begin(),
-												shapes.end(),
-												[t](ShapePtr aShape)
-												{
-													if(aShape->getModelObject())
-													{
-														return aShape->getModelObject()->getObjectId() == t->getObjectId();
-													}
-													return false;
-												});
-					if( result == shapes.end())
+					if (!getShapeFor( t->getObjectId()))
 					{
 						addShape(std::shared_ptr< S >(new S(t)));
 					}
@@ -0,0 +1,138 @@
+#ifndef SEQLOCK_HPP_
+#define SEQLOCK_HPP_
+
+#include "Config.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+namespace Base
+{
+	/**
+	 * A value that is written now and then and read often by other threads.
+	 *
+	 * Readers never block and never see a half written value: a reader copies the value and retries
+	 * if the sequence number changed while copying or a write was in progress. Writers are
+	 * serialised with a mutex and only make readers retry for the duration of the copy.
+	 *
+	 * The value is stored as an array of atomic words so the racing copy of a reader is not a data race.
+	 */
+	template< typename T >
+	class SeqLock
+	{
+			static_assert( std::is_trivially_copyable< T >::value, "SeqLock needs a trivially copyable type");
+
+		public:
+			/**
+			 *
+			 */
+			SeqLock() :
+						SeqLock( T())
+			{
+			}
+			/**
+			 *
+			 */
+			explicit SeqLock( const T& aValue) :
+						sequence( 0)
+			{
+				store( aValue);
+			}
+			/**
+			 *
+			 */
+			SeqLock( const SeqLock& aSeqLock) = delete;
+			/**
+			 *
+			 */
+			SeqLock& operator=( const SeqLock& aSeqLock) = delete;
+			/**
+			 * Returns a consistent copy of the value, spins while a write is in progress
+			 */
+			T load() const
+			{
+				Word copy[NumberOfWords];
+				std::uint64_t before;
+				std::uint64_t after;
+				do
+				{
+					before = sequence.load( std::memory_order_acquire);
+					for (std::size_t i = 0; i < NumberOfWords; ++i)
+					{
+						copy[i] = words[i].load( std::memory_order_relaxed);
+					}
+					std::atomic_thread_fence( std::memory_order_acquire);
+					after = sequence.load( std::memory_order_relaxed);
+				} while ((before & 1) != 0 || before != after);
+
+				T value;
+				std::memcpy( &value, copy, sizeof( T));
+				return value;
+			}
+			/**
+			 *
+			 */
+			void store( const T& aValue)
+			{
+				std::lock_guard< std::mutex > lock( writeMutex);
+				write( aValue);
+			}
+			/**
+			 * Applies aChange to the current value and stores the result, without losing
+			 * a concurrent write in between
+			 */
+			template< typename F >
+			void update( F aChange)
+			{
+				std::lock_guard< std::mutex > lock( writeMutex);
+				T value = load();
+				aChange( value);
+				write( value);
+			}
+
+		private:
+			/**
+			 *
+			 */
+			typedef std::uint64_t Word;
+			/**
+			 *
+			 */
+			static constexpr std::size_t NumberOfWords = (sizeof( T) + sizeof( Word) - 1) / sizeof( Word);
+			/**
+			 * To be called with writeMutex locked
+			 */
+			void write( const T& aValue)
+			{
+				Word copy[NumberOfWords] = {};
+				std::memcpy( copy, &aValue, sizeof( T));
+
+				std::uint64_t current = sequence.load( std::memory_order_relaxed);
+				// An odd sequence number tells the readers a write is in progress
+				sequence.store( current + 1, std::memory_order_relaxed);
+				std::atomic_thread_fence( std::memory_order_release);
+				for (std::size_t i = 0; i < NumberOfWords; ++i)
+				{
+					words[i].store( copy[i], std::memory_order_relaxed);
+				}
+				sequence.store( current + 2, std::memory_order_release);
+			}
+			/**
+			 *
+			 */
+			std::atomic< std::uint64_t > sequence;
+			/**
+			 *
+			 */
+			std::atomic< Word > words[NumberOfWords];
+			/**
+			 *
+			 */
+			std::mutex writeMutex;
+	};
+	// class SeqLock
+} // namespace Base
+#endif // SEQLOCK_HPP_
@@ -1,15 +1,94 @@
 #include "Server.hpp"
 
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace Messaging
 {
 	/**
 	 *
 	 */
 	Server::Server(unsigned short aPort, RequestHandlerPtr aRequestHandler) :
-					port(aPort),
-					acceptor(CommunicationService::getCommunicationService().getIOContext()),
+					Server(Address("", aPort), aRequestHandler)
+	{
+	}
+	/**
+	 *
+	 */
+	Server::Server(const Address& anAddress, RequestHandlerPtr aRequestHandler) :
+					address(anAddress.isLocal() ? anAddress : Address("", anAddress.port)),
+					acceptor(boost::asio::make_strand(CommunicationService::getCommunicationService().getIOContext())),
 					requestHandler(aRequestHandler),
-					timer( Messaging::CommunicationService::getCommunicationService().getIOContext())
+					timer( acceptor.get_executor())
+	{
+	}
+	/**
+	 *
+	 */
+	void Server::removeStaleSocketFile()
+	{
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+		struct stat status;
+		if (::lstat( address.socketPath.c_str(), &status) == -1)
+		{
+			// Nothing there, or the bind will tell what is wrong with the path
+			return;
+		}
+		if (!S_ISSOCK( status.st_mode))
+		{
+			throw std::runtime_error( "Server::startHandlingRequests: " + address.socketPath + " exists and is not a socket");
+		}
+
+		// Only a socket without a server refuses the connection
+		boost::asio::io_context ioContext;
+		boost::asio::local::stream_protocol::socket probe( ioContext);
+		boost::system::error_code error;
+		probe.connect( boost::asio::local::stream_protocol::endpoint( address.socketPath), error);
+		if (error != boost::asio::error::connection_refused)
+		{
+			throw std::runtime_error( "Server::startHandlingRequests: " + address.socketPath + " is in use" + (error ? ": " + error.message() : std::string( " by a running server")));
+		}
+		if (::unlink( address.socketPath.c_str()) == -1 && errno != ENOENT)
+		{
+			throw std::runtime_error( "Server::startHandlingRequests: cannot remove " + address.socketPath + ": " + std::strerror( errno));
+		}
+		TRACE_DEVELOP( "Server::startHandlingRequests: removed the stale socket " + address.socketPath);
+#endif
+	}
+	/**
+	 *
+	 */
+	void Server::rememberSocketFile()
+	{
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+		struct stat status;
+		if (::lstat( address.socketPath.c_str(), &status) == 0 && S_ISSOCK( status.st_mode))
+		{
+			socketFileBound = true;
+			socketFileDevice = static_cast< std::uint64_t >( status.st_dev);
+			socketFileInode = static_cast< std::uint64_t >( status.st_ino);
+		}
+#endif
+	}
+	/**
+	 *
+	 */
+	void Server::removeOwnSocketFile()
 	{
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+		struct stat status;
+		if (socketFileBound && ::lstat( address.socketPath.c_str(), &status) == 0 && S_ISSOCK( status.st_mode)
+						&& static_cast< std::uint64_t >( status.st_dev) == socketFileDevice && static_cast< std::uint64_t >( status.st_ino) == socketFileInode)
+		{
+			::unlink( address.socketPath.c_str());
+		}
+		socketFileBound = false;
+#endif
 	}
 } /* namespace Messaging */
@@ -3,17 +3,21 @@
 
 #include "Config.hpp"
 
+#include "Address.hpp"
+#include "Clock.hpp"
 #include "Session.hpp"
 #include "CommunicationService.hpp"
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 
 namespace Messaging
 {
 	/*
-	 *
+	 * Accepts connections on a TCP port or, for clients on the same host, on a Unix domain socket
 	 */
 	class Server : public std::enable_shared_from_this< Server >
 	{
@@ -24,22 +28,53 @@ namespace Messaging
 			Server(	unsigned short aPort,
 					RequestHandlerPtr aRequestHandler);
 			/**
-			 *
+			 * The host of a TCP address is ignored, the server listens on all interfaces
+			 */
+			Server(	const Address& anAddress,
+					RequestHandlerPtr aRequestHandler);
+			/**
+			 * @return 0 for a Unix domain socket
 			 */
 			unsigned short getPort() const
 			{
-				return port;
+				return address.port;
+			}
+			/**
+			 *
+			 */
+			const Address& getAddress() const
+			{
+				return address;
 			}
 			/**
 			 *
 			 */
 			void startHandlingRequests()
 			{
-				boost::asio::ip::tcp::endpoint ep(boost::asio::ip::tcp::v4(), port);
+				boost::asio::generic::stream_protocol::endpoint ep;
+				if (address.isLocal())
+				{
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+					removeStaleSocketFile();
+					ep = boost::asio::local::stream_protocol::endpoint(address.socketPath);
+#else
+					throw std::runtime_error( "Server::startHandlingRequests: no Unix domain sockets on this platform");
+#endif
+				}else
+				{
+					ep = boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), address.port);
+				}
 				acceptor.open(ep.protocol());
-				acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+				if (!address.isLocal())
+				{
+					acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+				}
 				acceptor.bind(ep);
 				acceptor.listen();
+				if (address.isLocal())
+				{
+					rememberSocketFile();
+				}
 
 				stopAccepting.store(false);
 				handleAccept( nullptr, boost::system::error_code());
@@ -51,16 +86,36 @@ namespace Messaging
 			{
 				stopAccepting.store(true);
 
-				timer.expires_from_now(boost::posix_time::seconds(1));
+				timer.expires_after(Base::Clock::getClock().getTimerDelay(std::chrono::seconds(1)));
 				timer.async_wait([this](const boost::system::error_code& UNUSEDPARAM(e)) // @suppress("Method cannot be resolved")
 								 {
-									boost::asio::post(	[this]() // @suppress("Invalid arguments")
+									boost::asio::post(	acceptor.get_executor(), // @suppress("Invalid arguments")
+														[this]()
 														{
 															acceptor.cancel();
+															if (address.isLocal())
+															{
+																removeOwnSocketFile();
+															}
 														});
 								 });
 			}
 		private:
+			/**
+			 * Removes the socket file at the address if an earlier run left it behind, i.e. if it is a
+			 * socket and nobody accepts connections on it
+			 *
+			 * @throw std::runtime_error if there is something else at the address or a server that is still running
+			 */
+			void removeStaleSocketFile();
+			/**
+			 * Remembers which file the bind created, so only that one is removed
+			 */
+			void rememberSocketFile();
+			/**
+			 * Removes the socket file if it is still the one this server bound
+			 */
+			void removeOwnSocketFile();
 			/**
 			 *	Handle any incoming connections
 			 *
@@ -146,10 +201,14 @@ namespace Messaging
 							handleAccept(session,error);
 												});
 
-						// If there is a session, start it up....
+						// If there is a session, start it up on its own strand....
 						if (aSession)
 						{
-							aSession->start();
+							boost::asio::post(	aSession->getSocket().get_executor(), // @suppress("Invalid arguments")
+												[aSession]()
+												{
+													aSession->start();
+												});
 						}
 					}else
 					{
@@ -174,11 +233,11 @@ namespace Messaging
 			/**
 			 *
 			 */
-			unsigned short port;
+			Address address;
 			/**
 			 * Provides the ability to accept new connections
 			 */
-			boost::asio::ip::tcp::acceptor acceptor;
+			boost::asio::basic_socket_acceptor< boost::asio::generic::stream_protocol > acceptor;
 			/**
 			 *
 			 */
@@ -190,7 +249,13 @@ namespace Messaging
 			/**
 			 *
 			 */
-			boost::asio::deadline_timer timer;
+			boost::asio::steady_timer timer;
+			/**
+			 * The device and inode of the socket file this server bound, if any
+			 */
+			bool socketFileBound = false;
+			std::uint64_t socketFileDevice = 0;
+			std::uint64_t socketFileInode = 0;
 	};
 	/**
 	 *
@@ -7,16 +7,32 @@
 #include "Message.hpp"
 #include "MessageHandler.hpp"
 #include "MessageTypes.hpp"
+#include "SharedMemorySession.hpp"
+#include "ThreadPool.hpp"
 
 #include <boost/asio.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace Messaging
 {
 	/**
 	 * A session is an encapsulation of a request/response transaction sequence.
+	 *
+	 * The socket is a generic stream socket, it is either a TCP socket or a Unix domain socket
+	 * depending on the Address it is connected to or accepted from.
+	 *
+	 * The socket of a session has its own strand as executor, all completion handlers of the
+	 * session run on that strand and thus one at a time, although the io_context is run by
+	 * more threads. Code that is not called from such a handler should post to socket.get_executor().
 	 */
 	class Session
 	{
@@ -25,14 +41,14 @@ namespace Messaging
 			 *
 			 */
 			Session() :
-					socket( CommunicationService::getCommunicationService().getIOContext())
+					socket( boost::asio::make_strand( CommunicationService::getCommunicationService().getIOContext()))
 			{
 			}
 			/**
 			 *
 			 */
 			explicit Session( const Message& aMessage) :
-					socket( CommunicationService::getCommunicationService().getIOContext()),
+					socket( boost::asio::make_strand( CommunicationService::getCommunicationService().getIOContext())),
 					message(aMessage)
 			{
 			}
@@ -47,14 +63,13 @@ namespace Messaging
 				}
 			}
 			/**
-			 * Typically a ServerSession has a read/write sequence,
-			 * a ClientSession a write/read sequence
+			 * Typically a ServerSession has a read/write sequence
 			 */
 			virtual void start() = 0;
 			/**
 			 * Handle the fact that a message is read. This function is called by the framework
 			 * after the message (header + body) is read. Normally this is the only function
-			 * that a ServerSession or ClientSession has to implement.
+			 * that a ServerSession has to implement.
 			 *
 			 * If message.getMessageType is CommunicationReadError the reading of the message failed
 			 * so an appropriate action should be taken.
@@ -63,7 +78,7 @@ namespace Messaging
 			/**
 			 * Handle the fact that a message is written. This function is called by the framework
 			 * after the message (header + body) is written. Normally this is the only function
-			 * that a ServerSession or ClientSession has to implement.
+			 * that a ServerSession has to implement.
 			 *
 			 * If message.getMessageType is CommunicationWriteError the writing of the message failed
 			 * so an appropriate action should be taken.
@@ -74,143 +89,184 @@ namespace Messaging
 			 *
 			 * @return the socket of this Session
 			 */
-			boost::asio::ip::tcp::socket& getSocket()
+			boost::asio::generic::stream_protocol::socket& getSocket()
 			{
 				return socket;
 			}
 		protected:
 			/**
-			 * readMessage will read the message in 2 a-sync reads, 1 for the header and 1 for the body.
-			 * After each read a callback will be called that should handle the bytes just read.
-			 * After reading the full message handleMessageRead will be called
-			 * whose responsibility it is to handle the message as a whole.
+			 * readMessage delivers the next message that arrives on the socket in message and then
+			 * calls handleMessageRead, whose responsibility it is to handle the message as a whole.
+			 *
+			 * The socket is read with as few reads as possible: every read takes whatever is available
+			 * into receiveBuffer, which is reused for all messages, and the messages are cut out of
+			 * it. If the next message is already in the buffer no read is needed at all, handleMessageRead
+			 * is then posted so it is never called from within readMessage.
 			 *
-			 * @see Session::handleHeaderRead
-			 * @see Session::handleBodyRead
+			 * A peer that still sends the ASCII header gets its responses with an ASCII header as well.
+			 *
+			 * @see Session::frameMessage
+			 * @see Session::handleDataRead
 			 * @see Session::handleMessageRead
 			 */
 			void readMessage()
 			{
-				headerBuffer.resize( message.getHeader().getHeaderLength());
-				boost::asio::async_read( socket, // @suppress("Invalid arguments")
-										 boost::asio::buffer( headerBuffer),
-										 [this](const boost::system::error_code& error,size_t bytes_transferred)
-										 {
-											handleHeaderRead(error,bytes_transferred);
-										 });
+				if (frameMessage())
+				{
+					boost::asio::post(	socket.get_executor(), // @suppress("Invalid arguments")
+										[this]()
+										{
+											handleMessageRead();
+										});
+					return;
+				}
+				receive();
 			}
 			/**
-			 * This function is called after the header bytes are read.
+			 * Starts a read of whatever is available into the free space of receiveBuffer
 			 */
-			void handleHeaderRead( 	const boost::system::error_code& error,
-									size_t UNUSEDPARAM(bytes_transferred))
+			void receive()
 			{
-				if (!error)
+				// Move the start of an incomplete message to the front, it is usually only a few bytes
+				if (receiveBegin > 0)
 				{
-					message.setHeader( Message::MessageHeader(std::string( headerBuffer.begin(), headerBuffer.end()))); // @suppress("Symbol is not resolved")
-					bodyBuffer.resize( message.getHeader().getMessageLength());
-					boost::asio::async_read( socket, // @suppress("Invalid arguments")
-											 boost::asio::buffer( bodyBuffer),
-											 [this](const boost::system::error_code& error,size_t bytes_transferred)
-											 {
-												handleBodyRead(error,bytes_transferred);
-											 });
-				} else
+					std::copy( receiveBuffer.begin() + static_cast< std::ptrdiff_t >( receiveBegin), receiveBuffer.begin() + static_cast< std::ptrdiff_t >( receiveEnd), receiveBuffer.begin());
+					receiveEnd -= receiveBegin;
+					receiveBegin = 0;
+				}
+				const std::size_t wanted = std::max( receiveEnd + minimumReceiveSize, expectedLength);
+				if (receiveBuffer.size() < wanted)
 				{
-					message.setMessageType(CommunicationReadError);
-					message.setBody("*** Session::handleHeaderRead: " + error.message());
-					handleMessageRead();
+					receiveBuffer.resize( std::max( wanted, 2 * receiveBuffer.size())); // @suppress("Avoid magic numbers")
 				}
+				socket.async_read_some( boost::asio::buffer( receiveBuffer.data() + receiveEnd, receiveBuffer.size() - receiveEnd), // @suppress("Invalid arguments")
+										[this](const boost::system::error_code& error,size_t bytes_transferred)
+										{
+											handleDataRead(error,bytes_transferred);
+										});
 			}
 			/**
-			 * This function as called after the body bytes are read.
-			 *
-			 * Any error handling (throwing an exception ;-)) is done in this function and
-			 * then the function with the same name but without the error is called.
+			 * This function is called after some bytes are read.
 			 */
-			void handleBodyRead( 	const boost::system::error_code& error,
+			void handleDataRead(	const boost::system::error_code& error,
 									size_t bytes_transferred)
 			{
-				if (!error)
+				if (!error && socket.is_open())
 				{
-					message.setBody( std::string( bodyBuffer.begin(), bodyBuffer.end())); // @suppress("Symbol is not resolved")
-					handleMessageRead( error, bytes_transferred);
+					receiveEnd += bytes_transferred;
+					if (frameMessage())
+					{
+						handleMessageRead();
+					} else
+					{
+						receive();
+					}
 				} else
 				{
 					message.setMessageType(CommunicationReadError);
-					message.setBody("*** Session::handleBodyRead: " + error.message());
+					message.setBody("*** Session::handleDataRead: " + (error ? error.message() : std::string( "socket closed")));
 					handleMessageRead();
 				}
 			}
 			/**
-			 * This function is called after both the header and body bytes are read.
+			 * Cuts the next message out of receiveBuffer into message.
+			 *
+			 * @return false if the buffer does not hold a complete message yet, true if the message is
+			 * ready or the header is invalid or announces more than MessageHeader::maxMessageLength, in
+			 * which case message is a CommunicationReadError
 			 */
-			void handleMessageRead( const boost::system::error_code& error,
-									size_t UNUSEDPARAM(bytes_transferred))
+			bool frameMessage()
 			{
-				if (!error)
+				const std::size_t available = receiveEnd - receiveBegin;
+				if (available < Message::MessageHeader::binaryHeaderLength)
 				{
-					handleMessageRead();
-				} else
+					return false;
+				}
+				const char* data = receiveBuffer.data() + receiveBegin;
+
+				Message::MessageHeader header;
+				std::size_t headerLength = Message::MessageHeader::binaryHeaderLength;
+				if (Message::MessageHeader::isAsciiHeader( data))
+				{
+					headerLength = Message::MessageHeader::getAsciiHeaderLength( data);
+					if (headerLength == 0)
+					{
+						message.setMessageType(CommunicationReadError);
+						message.setBody("*** Session::frameMessage: unknown header version");
+						return true;
+					}
+					if (available < headerLength)
+					{
+						return false;
+					}
+					asciiMinorVersion = data[5];
+					header.fromString( std::string( data, headerLength));
+				} else if (!header.decode( data))
 				{
 					message.setMessageType(CommunicationReadError);
-					message.setBody("*** Session::handleMessageRead: " + error.message());
-					handleMessageRead();
+					message.setBody("*** Session::frameMessage: invalid header");
+					return true;
 				}
+
+				if (header.getMessageLength() > Message::MessageHeader::maxMessageLength)
+				{
+					message.setMessageType(CommunicationReadError);
+					message.setBody("*** Session::frameMessage: message length " + std::to_string( header.getMessageLength()) + " exceeds the maximum");
+					return true;
+				}
+
+				const std::size_t messageLength = headerLength + header.getMessageLength();
+				if (available < messageLength)
+				{
+					expectedLength = messageLength;
+					return false;
+				}
+				expectedLength = 0;
+
+				// setHeader only resizes the body, its capacity is kept from one message to the next
+				message.setHeader( header);
+				message.message.assign( data + headerLength, header.getMessageLength());
+				receiveBegin += messageLength;
+				if (receiveBegin == receiveEnd)
+				{
+					receiveBegin = receiveEnd = 0;
+				}
+				return true;
 			}
 			/**
-			 * writeMessage will write the message in 2 a-sync writes, 1 for the header and 1 for the body.
-			 * After each write a callback will be called that should handle the bytes just read.
-			 * After writing the full message handleMessageWritten will be called.
-			 *
-			 * @see Session::handleHeaderWritten
-			 * @see Session::handleBodyWritten
-			 * @see Session::handleMessageWritten
-			 */
-			void writeMessage( const Message& aMessage)
-			{
-				message = aMessage;
-				boost::asio::async_write(socket, // @suppress("Invalid arguments")
-										 boost::asio::buffer( message.getHeader().toString(), message.getHeader().getHeaderLength()),
-										 [this, aMessage](const boost::system::error_code& error, std::size_t UNUSEDPARAM(bytes_transferred))
-										 {
-											handleHeaderWritten(error);
-										 });
-			}
-			/**
-			 * This function is called after the header bytes are written.
+			 * Forgets the bytes that were received and the header format of the peer, for a socket that is connected again
 			 */
-			void handleHeaderWritten(	const boost::system::error_code& error)
+			void resetReceiveBuffer()
 			{
-				if (!error)
-				{
-					boost::asio::async_write(	socket, // @suppress("Invalid arguments")
-												boost::asio::buffer( message.getBody(), message.length()),
-												[this](const boost::system::error_code& error, std::size_t UNUSEDPARAM(bytes_transferred))
-												{
-													handleBodyWritten(error);
-												});
-				} else
-				{
-					message.setMessageType(CommunicationWriteError);
-					message.setBody("*** Session::handleHeaderWritten: " + error.message());
-					handleMessageWritten();
-				}
+				receiveBegin = receiveEnd = expectedLength = 0;
+				asciiMinorVersion = 0;
 			}
 			/**
-			 * This function is called after the body bytes are written.
+			 * writeMessage writes the header and the body of the message in 1 a-sync gather write.
+			 * After writing the full message handleMessageWritten will be called.
+			 *
+			 * @see Session::handleMessageWritten
 			 */
-			void handleBodyWritten( const boost::system::error_code& error)
+			void writeMessage( const Message& aMessage)
 			{
-				if (!error)
+				// The buffers must stay alive until the write is done, and a read may use message meanwhile.
+				// Both are assigned, not constructed, so their capacity is reused.
+				outgoingMessage = aMessage;
+				if (asciiMinorVersion != 0)
 				{
-					handleMessageWritten( error);
+					outgoingHeader = outgoingMessage.getHeader().toString( asciiMinorVersion);
 				} else
 				{
-					message.setMessageType(CommunicationWriteError);
-					message.setBody("*** Session::handleBodyWritten: " + error.message());
-					handleMessageWritten();
+					outgoingHeader.resize( Message::MessageHeader::binaryHeaderLength);
+					outgoingMessage.getHeader().encode( &outgoingHeader[0]);
 				}
+				const std::array< boost::asio::const_buffer, 2 > buffers{ boost::asio::buffer( outgoingHeader), boost::asio::buffer( outgoingMessage.message)};
+				boost::asio::async_write(socket, // @suppress("Invalid arguments")
+										 buffers,
+										 [this](const boost::system::error_code& error, std::size_t UNUSEDPARAM(bytes_transferred))
+										 {
+											handleMessageWritten(error);
+										 });
 			}
 			/**
 			 * This function is called after both the header and body bytes are written.
@@ -225,31 +281,105 @@ namespace Messaging
 					handleMessageWritten();
 				} else
 				{
-					message.setMessageType(CommunicationWriteError);
-					message.setBody("*** Session::handleMessageWritten: " + error.message());
+					outgoingMessage.setMessageType(CommunicationWriteError);
+					outgoingMessage.setBody("*** Session::handleMessageWritten: " + error.message());
 					handleMessageWritten();
 				}
 			}
 			/*
 			 *
 			 */
-			boost::asio::ip::tcp::socket socket;
+			boost::asio::generic::stream_protocol::socket socket;
 			/*
-			 *
+			 * The message that is read last
 			 */
 			Message message;
 			/**
-			 *
+			 * The message that is written last, separate from message so a read and a write can be in progress at the same time
 			 */
-			std::vector< char > headerBuffer;
+			Message outgoingMessage;
 			/**
 			 *
 			 */
-			std::vector< char > bodyBuffer;
+			std::string outgoingHeader;
+			/**
+			 * The bytes received but not delivered yet are [receiveBegin, receiveEnd)
+			 */
+			std::vector< char > receiveBuffer;
+			std::size_t receiveBegin = 0;
+			std::size_t receiveEnd = 0;
+			/**
+			 * The length of the message that is partly received, 0 if its header is not complete yet
+			 */
+			std::size_t expectedLength = 0;
+			/**
+			 * The minor version of the ASCII header the peer sent, from then on it gets ASCII headers
+			 * of that version as well. 0 as long as the peer sends binary headers.
+			 */
+			char asciiMinorVersion = 0;
+			/**
+			 * The free space a read asks for at least
+			 */
+			static const std::size_t minimumReceiveSize = 4096;
 	};
 	// class Session
+	class ServerSession;
+	/**
+	 * A Subscription on a ServerSession. It outlives the session if the request handler keeps it,
+	 * but it only touches the session on the strand of the session and only while it is active.
+	 */
+	class SessionSubscription :	public Subscription,
+								public std::enable_shared_from_this< SessionSubscription >
+	{
+		public:
+			/**
+			 *
+			 */
+			SessionSubscription(	ServerSession* aSession,
+									const boost::asio::any_io_executor& anExecutor,
+									unsigned long aCorrelationId) :
+										session( aSession),
+										executor( anExecutor),
+										correlationId( aCorrelationId),
+										active( true)
+			{
+			}
+			/**
+			 * @see Subscription::publish( const Message& aMessage)
+			 */
+			virtual bool publish( const Message& aMessage) override;
+			/**
+			 * @see Subscription::isActive()
+			 */
+			virtual bool isActive() const override
+			{
+				return active.load();
+			}
+			/**
+			 * Called on the strand of the session when the session ends
+			 */
+			void deactivate()
+			{
+				active.store( false);
+			}
+
+		private:
+			ServerSession* session;
+			boost::asio::any_io_executor executor;
+			unsigned long correlationId;
+			std::atomic< bool > active;
+	};
+	// class SessionSubscription
+	typedef std::shared_ptr< SessionSubscription > SessionSubscriptionPtr;
 	/**
+	 * Reads requests and writes the responses, and the messages published to the subscriptions of
+	 * the session, until the client closes the connection.
 	 *
+	 * The next request is read while the response to the previous one is still being written, the
+	 * responses are queued and written one at a time in the order of the requests.
+	 *
+	 * A client on the same host may move the session to a SharedMemoryChannel, the socket then
+	 * only tells when the client is gone.
 	 */
 	class ServerSession : virtual public Session
 	{
@@ -268,6 +398,11 @@ namespace Messaging
 			 */
 			virtual void start() override
 			{
+				// The connection is kept open for more requests, do not let Nagle hold back the responses.
+				// A Unix domain socket has no Nagle, the option just fails.
+				boost::system::error_code error;
+				socket.set_option( boost::asio::ip::tcp::no_delay( true), error);
+				receiving = true;
 				readMessage();
 			}
 			/**
@@ -275,14 +410,52 @@ namespace Messaging
 			 */
 			virtual void handleMessageRead() override
 			{
-				if(message.getMessageType() != CommunicationReadError)
+				if(message.getMessageType() == SharedMemoryRequest)
+				{
+					attachSharedMemory();
+				}else if(message.getMessageType() != CommunicationReadError)
 				{
-					requestHandler->handleRequest( message);
-					writeMessage( message);
+					SessionSubscriptionPtr subscription;
+					if (message.isStream())
+					{
+						subscription = std::make_shared< SessionSubscription >( this, socket.get_executor(), message.getCorrelationId());
+						subscriptions.push_back( subscription);
+					}
+
+					// The handler may take its time, let it run on the ThreadPool instead of an io thread.
+					// Nothing else touches message until the response is queued.
+					Base::ThreadPool::getThreadPool().submit( [this, subscription]()
+					{
+						// Whatever the handler does, the client gets a response and the session reads on
+						try
+						{
+							if (subscription)
+							{
+								requestHandler->handleSubscription( message, subscription);
+							} else
+							{
+								requestHandler->handleRequest( message);
+							}
+						}
+						catch (std::exception& e)
+						{
+							setExceptionResponse( subscription, e.what());
+						}
+						catch (...)
+						{
+							setExceptionResponse( subscription, "unknown exception");
+						}
+						boost::asio::post(	socket.get_executor(), // @suppress("Invalid arguments")
+											[this]()
+											{
+												handleRequestHandled();
+											});
+					});
 				}else
 				{
 					TRACE_DEVELOP("*** ServerSession::handleMessageRead: " + message.asString());
-					delete this;
+					receiving = false;
+					fail();
 				}
 			}
 			/**
@@ -290,96 +463,160 @@ namespace Messaging
 			 */
 			virtual void handleMessageWritten() override
 			{
-				if(message.getMessageType() != CommunicationWriteError)
+				writing = false;
+				if(outgoingMessage.getMessageType() == CommunicationWriteError)
 				{
-					//
-				}else
+					TRACE_DEVELOP("*** ServerSession::handleMessageWritten: " + outgoingMessage.asString());
+					fail();
+					return;
+				}
+				if (failed)
 				{
-					TRACE_DEVELOP("*** ServerSession::handleMessageWritten: " + message.asString());
+					fail();
+					return;
 				}
-				// See https://isocpp.org/wiki/faq/freestore-mgmt#delete-this
-				delete this;
+				writeNextMessage();
 			}
-
-		private:
 			/**
-			 *
+			 * Queues aMessage for writing, must be called on the strand of the session
 			 */
-			RequestHandlerPtr  requestHandler;
+			void sendMessage( const Message& aMessage)
+			{
+				if (failed)
+				{
+					return;
+				}
+				unwrittenMessages.push_back( aMessage);
+				writeNextMessage();
+			}
+
+		private:
 			/**
-			 *
+			 * Opens the SharedMemoryChannel that the client named in message and serves the
+			 * requests on it from now on. An empty body in the response means the channel is accepted.
 			 */
-			unsigned long sessionNumber = 0;
+			void attachSharedMemory()
+			{
+				SharedMemoryChannelPtr channel;
+				if (!sharedMemorySession && CommunicationService::isSharedMemoryEnabled())
+				{
+					channel = SharedMemoryChannel::open( message.getBody());
+				}
+				message.setMessageType( SharedMemoryResponse);
+				if (channel)
+				{
+					sharedMemorySession = std::make_shared< SharedMemorySession >( channel, requestHandler);
+					sharedMemorySession->start();
+					message.setBody( "");
+				} else
+				{
+					message.setBody( "refused");
+				}
+				sendMessage( message);
+				readMessage();
+			}
 			/**
-			 *
+			 * Turns message into a ServerSideExceptionResponse for a request handler that threw.
+			 * The response is final: a subscription ends with it.
 			 */
-			inline static unsigned long sessionCounter = 0;
-	};
-	// class ServerSession
-	/**
-	 *
-	 */
-	class ClientSession : virtual public Session
-	{
-		public:
-			/**
-			 *
-			 * @param aMessage
-			 * @param aResponseHandler
-			 */
-			ClientSession( 	const Message& aMessage,
-							ResponseHandlerPtr aResponseHandler) :
-							Session( aMessage),
-							responseHandler( aResponseHandler)
+			void setExceptionResponse(	const SessionSubscriptionPtr& aSubscription,
+										const std::string& aWhat)
 			{
-				sessionNumber = ++sessionCounter;
+				TRACE_DEVELOP( "*** ServerSession: request handler failed on " + message.asString() + ": " + aWhat);
+				if (aSubscription)
+				{
+					aSubscription->deactivate();
+				}
+				message.setMessageType( ServerSideExceptionResponse);
+				message.setFlags( static_cast< unsigned char >( message.getFlags() & ~Message::Stream));
+				message.setBody( aWhat);
 			}
 			/**
-			 * @see Session::start()
+			 * Called on the strand when the request handler is done with message
 			 */
-			virtual void start() override
+			void handleRequestHandled()
 			{
-				writeMessage( message);
+				if (failed)
+				{
+					receiving = false;
+					fail();
+					return;
+				}
+				sendMessage( message);
+				// Clients keep their Connection open, wait for the next request on the same socket.
+				// The session ends when the client closes the connection.
+				readMessage();
 			}
 			/**
-			 * @see Session::handleMessageRead( Message& aMessage)
+			 *
 			 */
-			virtual void handleMessageRead() override
+			void writeNextMessage()
 			{
-				if(message.getMessageType() != CommunicationReadError)
-				{
-					// This is the place where any reply message from the server should
-					// be handled
-					responseHandler->handleResponse( message);
-				}else
+				if (writing || unwrittenMessages.empty())
 				{
-					TRACE_DEVELOP("*** ClientSession::handleMessageRead: " + message.asString());
+					return;
 				}
-
-				// See https://isocpp.org/wiki/faq/freestore-mgmt#delete-this
-				delete this;
+				writing = true;
+				writeMessage( unwrittenMessages.front());
+				unwrittenMessages.pop_front();
 			}
 			/**
-			 * @see Session::handleMessageWritten( Message& aMessage)
+			 * Closes the socket, ends the subscriptions and deletes the session as soon as no read,
+			 * request handler or write refers to it anymore
 			 */
-			virtual void handleMessageWritten() override
+			void fail()
 			{
-				if(message.getMessageType() != CommunicationWriteError)
+				if (!failed)
 				{
-					// This *must* be the last function that is called after
-					// sending a message because it will read the response...
-					readMessage();
-				}else
+					failed = true;
+					for (const SessionSubscriptionPtr& subscription : subscriptions)
+					{
+						subscription->deactivate();
+					}
+					subscriptions.clear();
+					unwrittenMessages.clear();
+					if (sharedMemorySession)
+					{
+						sharedMemorySession->stop();
+						sharedMemorySession.reset();
+					}
+					boost::system::error_code error;
+					socket.close( error);
+				}
+				if (!receiving && !writing)
 				{
-					TRACE_DEVELOP("*** ClientSession::handleMessageWritten: " + message.asString());
+					// See https://isocpp.org/wiki/faq/freestore-mgmt#delete-this
 					delete this;
 				}
 			}
-		private:
 			/**
 			 *
 			 */
-			ResponseHandlerPtr responseHandler;
+			RequestHandlerPtr  requestHandler;
+			/**
+			 * True while a read is pending or the request handler runs
+			 */
+			bool receiving = false;
+			/**
+			 *
+			 */
+			bool writing = false;
+			/**
+			 *
+			 */
+			bool failed = false;
+			/**
+			 * Responses and published messages that wait for the current write
+			 */
+			std::deque< Message > unwrittenMessages;
+			/**
+			 *
+			 */
+			std::vector< SessionSubscriptionPtr > subscriptions;
+			/**
+			 *
+			 */
+			SharedMemorySessionPtr sharedMemorySession;
 			/**
 			 *
 			 */
@@ -389,7 +626,32 @@ namespace Messaging
 			 */
 			inline static unsigned long sessionCounter = 0;
 	};
-//	class ClientSession
+	// class ServerSession
+	/**
+	 *
+	 */
+	inline bool SessionSubscription::publish( const Message& aMessage)
+	{
+		if (!active.load())
+		{
+			return false;
+		}
+		Message published( aMessage);
+		published.setCorrelationId( correlationId);
+		published.setFlags( published.getFlags() | Message::Stream);
+
+		SessionSubscriptionPtr self = shared_from_this();
+		boost::asio::post(	executor, // @suppress("Invalid arguments")
+							[self, published]()
+							{
+								// The session is only deleted on its strand after it deactivated its subscriptions
+								if (self->active.load())
+								{
+									self->session->sendMessage( published);
+								}
+							});
+		return true;
+	}
 
 }// namespace Messaging
 
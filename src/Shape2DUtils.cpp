@@ -44,6 +44,40 @@ namespace Utils
 		return GetAngle( aStartpoint, anEndPoint);
 	}
 
+	/**
+	 *
+	 */
+	/* static */long long Shape2DUtils::orient2d(	const wxPoint& aPoint1,
+													const wxPoint& aPoint2,
+													const wxPoint& aPoint3)
+	{
+		long long abx = static_cast<long long>(aPoint2.x) - aPoint1.x;
+		long long aby = static_cast<long long>(aPoint2.y) - aPoint1.y;
+		long long acx = static_cast<long long>(aPoint3.x) - aPoint1.x;
+		long long acy = static_cast<long long>(aPoint3.y) - aPoint1.y;
+
+		return abx * acy - aby * acx;
+	}
+	/**
+	 *
+	 */
+	/* static */bool Shape2DUtils::boundingBoxesOverlap(	const wxPoint& aStartLine1,
+															const wxPoint& anEndLine1,
+															const wxPoint& aStartLine2,
+															const wxPoint& anEndLine2)
+	{
+		if (std::max( aStartLine1.x, anEndLine1.x) < std::min( aStartLine2.x, anEndLine2.x) ||
+			std::max( aStartLine2.x, anEndLine2.x) < std::min( aStartLine1.x, anEndLine1.x))
+		{
+			return false;
+		}
+		if (std::max( aStartLine1.y, anEndLine1.y) < std::min( aStartLine2.y, anEndLine2.y) ||
+			std::max( aStartLine2.y, anEndLine2.y) < std::min( aStartLine1.y, anEndLine1.y))
+		{
+			return false;
+		}
+		return true;
+	}
 	/**
 	 *
 	 */
@@ -52,7 +86,104 @@ namespace Utils
 												const wxPoint& aStartLine2,
 												const wxPoint& anEndLine2)
 	{
-		return Shape2DUtils::getIntersection(	aStartLine1,anEndLine1,aStartLine2,anEndLine2) != wxDefaultPosition;
+		// Cheap rejection first: most segment pairs in the world are nowhere near each other
+		if (!boundingBoxesOverlap( aStartLine1, anEndLine1, aStartLine2, anEndLine2))
+		{
+			return false;
+		}
+
+		long long d1 = orient2d( aStartLine2, anEndLine2, aStartLine1);
+		long long d2 = orient2d( aStartLine2, anEndLine2, anEndLine1);
+		long long d3 = orient2d( aStartLine1, anEndLine1, aStartLine2);
+		long long d4 = orient2d( aStartLine1, anEndLine1, anEndLine2);
+
+		// Proper crossing: each segment straddles the line through the other
+		if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)))
+		{
+			return true;
+		}
+
+		// Touching or collinear overlap
+		if (d1 == 0 && isOnCollinearSegment( aStartLine2, anEndLine2, aStartLine1))
+		{
+			return true;
+		}
+		if (d2 == 0 && isOnCollinearSegment( aStartLine2, anEndLine2, anEndLine1))
+		{
+			return true;
+		}
+		if (d3 == 0 && isOnCollinearSegment( aStartLine1, anEndLine1, aStartLine2))
+		{
+			return true;
+		}
+		if (d4 == 0 && isOnCollinearSegment( aStartLine1, anEndLine1, anEndLine2))
+		{
+			return true;
+		}
+		return false;
+	}
+	/**
+	 *
+	 */
+	/* static */bool Shape2DUtils::sweep(	const wxPoint* aPolygon,
+											int aNumberOfPoints,
+											const wxPoint& aDisplacement,
+											const wxPoint& aStartLine,
+											const wxPoint& anEndLine,
+											double& aTimeOfImpact)
+	{
+		// The bounding box of the swept polygon must overlap the segment's
+		int minX = aPolygon[0].x;
+		int minY = aPolygon[0].y;
+		int maxX = aPolygon[0].x;
+		int maxY = aPolygon[0].y;
+		for (int i = 1; i < aNumberOfPoints; ++i)
+		{
+			minX = std::min( minX, aPolygon[i].x);
+			minY = std::min( minY, aPolygon[i].y);
+			maxX = std::max( maxX, aPolygon[i].x);
+			maxY = std::max( maxY, aPolygon[i].y);
+		}
+		if (!boundingBoxesOverlap(	wxPoint( std::min( minX, minX + aDisplacement.x), std::min( minY, minY + aDisplacement.y)),
+									wxPoint( std::max( maxX, maxX + aDisplacement.x), std::max( maxY, maxY + aDisplacement.y)),
+									aStartLine,
+									anEndLine))
+		{
+			return false;
+		}
+
+		bool hit = false;
+		double earliest = 1.0;
+		double time = 0.0;
+
+		const wxPoint reverse( -aDisplacement.x, -aDisplacement.y);
+		for (int i = 0; i < aNumberOfPoints; ++i)
+		{
+			const wxPoint& vertex = aPolygon[i];
+			const wxPoint& nextVertex = aPolygon[(i + 1) % aNumberOfPoints];
+
+			if (castRay( vertex, aDisplacement, aStartLine, anEndLine, time) && time <= earliest)
+			{
+				hit = true;
+				earliest = time;
+			}
+			if (castRay( aStartLine, reverse, vertex, nextVertex, time) && time <= earliest)
+			{
+				hit = true;
+				earliest = time;
+			}
+			if (castRay( anEndLine, reverse, vertex, nextVertex, time) && time <= earliest)
+			{
+				hit = true;
+				earliest = time;
+			}
+		}
+
+		if (hit)
+		{
+			aTimeOfImpact = earliest;
+		}
+		return hit;
 	}
 	/**
 	 *
@@ -132,6 +263,11 @@ namespace Utils
 
 		// I don't know where this is from...
 
+		if (!Shape2DUtils::intersect( aStartLine1, anEndLine1, aStartLine2, anEndLine2))
+		{
+			return wxDefaultPosition;
+		}
+
 		double x1 = aStartLine1.x;
 		double x2 = anEndLine1.x;
 		double x3 = aStartLine2.x;
@@ -142,10 +278,25 @@ namespace Utils
 		double y4 = anEndLine2.y;
 
 		double d = (x1 - x2) * (y3 - y4) - (y1 - y2) * (x3 - x4);
-		// If d is zero, there is no intersection
+		// If d is zero the segments are parallel, and as they intersect they overlap on one line (or one of
+		// them is a single point). The overlap is a segment itself, return its end point that comes first
+		// from aStartLine1.
 		if (std::fabs(d-0.0) <= std::numeric_limits<float>::epsilon())
 		{
-			return wxDefaultPosition;
+			const wxPoint endPoints[] = { aStartLine1, anEndLine1, aStartLine2, anEndLine2 };
+			wxPoint first = wxDefaultPosition;
+			double firstDistance = std::numeric_limits< double >::max();
+			for (const wxPoint& endPoint : endPoints)
+			{
+				if (orient2d( aStartLine1, anEndLine1, endPoint) == 0 && isOnCollinearSegment( aStartLine1, anEndLine1, endPoint) &&
+					orient2d( aStartLine2, anEndLine2, endPoint) == 0 && isOnCollinearSegment( aStartLine2, anEndLine2, endPoint) &&
+					distance( aStartLine1, endPoint) < firstDistance)
+				{
+					first = endPoint;
+					firstDistance = distance( aStartLine1, endPoint);
+				}
+			}
+			return first;
 		}
 
 		// Get the x and y
@@ -399,6 +550,59 @@ namespace Utils
 		os << aSize.x << " x " << aSize.y;
 		return os.str();
 	}
+	/**
+	 *
+	 */
+	/* static */bool Shape2DUtils::isOnCollinearSegment(	const wxPoint& aStartPoint,
+															const wxPoint& anEndPoint,
+															const wxPoint& aPoint)
+	{
+		return	aPoint.x >= std::min( aStartPoint.x, anEndPoint.x) && aPoint.x <= std::max( aStartPoint.x, anEndPoint.x) &&
+				aPoint.y >= std::min( aStartPoint.y, anEndPoint.y) && aPoint.y <= std::max( aStartPoint.y, anEndPoint.y);
+	}
+	/**
+	 *
+	 */
+	/* static */bool Shape2DUtils::castRay(	const wxPoint& aStartPoint,
+											const wxPoint& aDirection,
+											const wxPoint& aStartLine,
+											const wxPoint& anEndLine,
+											double& aTime)
+	{
+		const wxPoint endPoint( aStartPoint.x + aDirection.x, aStartPoint.y + aDirection.y);
+		if (!intersect( aStartPoint, endPoint, aStartLine, anEndLine))
+		{
+			return false;
+		}
+
+		// Solve aStartPoint + t * aDirection = aStartLine + u * (anEndLine - aStartLine) with exact cross products
+		long long dx = aDirection.x;
+		long long dy = aDirection.y;
+		long long ex = static_cast< long long >(anEndLine.x) - aStartLine.x;
+		long long ey = static_cast< long long >(anEndLine.y) - aStartLine.y;
+		long long qx = static_cast< long long >(aStartLine.x) - aStartPoint.x;
+		long long qy = static_cast< long long >(aStartLine.y) - aStartPoint.y;
+
+		long long denominator = dx * ey - dy * ex;
+		if (denominator != 0)
+		{
+			aTime = static_cast< double >(qx * ey - qy * ex) / static_cast< double >(denominator);
+			return true;
+		}
+
+		// Parallel and, as they intersect, collinear: the first contact is the nearest segment end point
+		// in front of aStartPoint, or aStartPoint itself if it already lies on the segment
+		long long lengthSquared = dx * dx + dy * dy;
+		if (lengthSquared == 0 || isOnCollinearSegment( aStartLine, anEndLine, aStartPoint))
+		{
+			aTime = 0.0;
+			return true;
+		}
+		long long rx = static_cast< long long >(anEndLine.x) - aStartPoint.x;
+		long long ry = static_cast< long long >(anEndLine.y) - aStartPoint.y;
+		aTime = static_cast< double >(std::min( qx * dx + qy * dy, rx * dx + ry * dy)) / static_cast< double >(lengthSquared);
+		return true;
+	}
 	/**
 	 *
 	 */
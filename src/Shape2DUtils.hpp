@@ -33,6 +33,34 @@ namespace Utils
 			static double getAngle( const wxPoint& aStartpoint,
 									const wxPoint& anEndPoint);
 			/**
+			 * Exact integer orientation test. The result is computed in 64 bits so it cannot
+			 * overflow for any pair of int coordinates that differ by less than 2^31.
+			 *
+			 * @param aPoint1
+			 * @param aPoint2
+			 * @param aPoint3
+			 * @return > 0 if aPoint3 lies counterclockwise of the directed line aPoint1->aPoint2,
+			 * < 0 if it lies clockwise and 0 if the three points are collinear
+			 */
+			static long long orient2d(	const wxPoint& aPoint1,
+										const wxPoint& aPoint2,
+										const wxPoint& aPoint3);
+			/**
+			 *
+			 * @param aStartLine1
+			 * @param anEndLine1
+			 * @param aStartLine2
+			 * @param anEndLine2
+			 * @return true if the axis aligned bounding boxes of both line segments overlap (touching counts)
+			 */
+			static bool boundingBoxesOverlap(	const wxPoint& aStartLine1,
+												const wxPoint& anEndLine1,
+												const wxPoint& aStartLine2,
+												const wxPoint& anEndLine2);
+			/**
+			 * Exact segment intersection test: a bounding box early-out followed by orientation tests.
+			 * No division or floating point is involved, touching and collinear overlapping segments
+			 * count as intersecting.
 			 *
 			 * @param aStartLine1
 			 * @param aEndLine1
@@ -44,13 +72,37 @@ namespace Utils
 									const wxPoint& anEndLine1,
 									const wxPoint& aStartLine2,
 									const wxPoint& anEndLine2);
+			/**
+			 * Continuous collision test of a polygon that is translated over aDisplacement against a
+			 * static line segment. The swept polygon touches the segment at the earliest time where
+			 * either a polygon vertex, moving along aDisplacement, hits the segment or a segment end
+			 * point, moving along -aDisplacement, hits a polygon edge.
+			 *
+			 * @param aPolygon The array of points of the polygon at time 0
+			 * @param aNumberOfPoints The number of points in the array
+			 * @param aDisplacement The translation of the polygon between time 0 and time 1
+			 * @param aStartLine
+			 * @param anEndLine
+			 * @param aTimeOfImpact Set to the time of first contact in [0,1] if there is one, untouched otherwise
+			 * @return true if the polygon touches the segment while being moved
+			 */
+			static bool sweep(	const wxPoint* aPolygon,
+								int aNumberOfPoints,
+								const wxPoint& aDisplacement,
+								const wxPoint& aStartLine,
+								const wxPoint& anEndLine,
+								double& aTimeOfImpact);
 			/**
 			 *
 			 * @param aStartLine1
 			 * @param aEndLine1
 			 * @param aStartLine2
 			 * @param anEndLine2
-			 * @return a valid wxPoint it the ;lines intersect, wxDefaultPosition otherwise
+			 * @return a valid wxPoint it the ;lines intersect, wxDefaultPosition otherwise. If they overlap
+			 * on one line, the end point of the overlap that is nearest to aStartLine1.
+			 *
+			 * Note that an intersection at (-1,-1) is indistinguishable from a miss, use intersect()
+			 * when only a yes/no answer is needed.
 			 */
 			static wxPoint getIntersection(	const wxPoint& aStartLine1,
 											const wxPoint& anEndLine1,
@@ -157,6 +209,22 @@ namespace Utils
 			static std::string asString( const wxSize& aSize);
 
 		protected:
+			/**
+			 *
+			 * @return true if aPoint, known to be collinear with the segment, lies within the segment's bounding box
+			 */
+			static bool isOnCollinearSegment(	const wxPoint& aStartPoint,
+												const wxPoint& anEndPoint,
+												const wxPoint& aPoint);
+			/**
+			 *
+			 * @return true if the ray aStartPoint + t * aDirection, t in [0,1], hits the segment, aTime is then set to t
+			 */
+			static bool castRay(	const wxPoint& aStartPoint,
+									const wxPoint& aDirection,
+									const wxPoint& aStartLine,
+									const wxPoint& anEndLine,
+									double& aTime);
 			static double rotateX(	const wxPoint& aPoint,
 									double anAngle);
 			static double rotateY(	const wxPoint& aPoint,
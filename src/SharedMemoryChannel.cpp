@@ -0,0 +1,462 @@
+#include "SharedMemoryChannel.hpp"
+
+#include "LockFreeQueue.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace Messaging
+{
+	/**
+	 * The indexes run freely and wrap around at 2^32, the ring size is a power of 2 that divides
+	 * that, so tail - head is always the number of bytes in the ring.
+	 */
+	struct SharedMemoryChannel::Ring
+	{
+			/**
+			 * Only written by the reader
+			 */
+			alignas(Base::CacheLineSize) std::atomic< std::uint32_t > head;
+			/**
+			 * Only written by the writer
+			 */
+			alignas(Base::CacheLineSize) std::atomic< std::uint32_t > tail;
+			/**
+			 * Set by a side that is about to sleep on the index of the other side
+			 */
+			alignas(Base::CacheLineSize) std::atomic< std::uint32_t > readerWaiting;
+			std::atomic< std::uint32_t > writerWaiting;
+	};
+	/**
+	 * The start of the segment, followed by the data of both rings
+	 */
+	struct SharedMemoryChannel::Segment
+	{
+			Segment() :
+						magic( segmentMagic),
+						ringSize( segmentRingSize),
+						closed( 0)
+			{
+				for (Ring& ring : rings)
+				{
+					ring.head.store( 0);
+					ring.tail.store( 0);
+					ring.readerWaiting.store( 0);
+					ring.writerWaiting.store( 0);
+				}
+			}
+			std::uint32_t magic;
+			std::uint32_t ringSize;
+			std::atomic< std::uint32_t > closed;
+			/**
+			 * [0] from the client to the server, [1] from the server to the client
+			 */
+			Ring rings[2];
+
+			static const std::uint32_t segmentMagic = 0x4D535752; // 'R' 'W' 'S' 'M' in little-endian
+			static const std::uint32_t segmentRingSize = 1 << 20; // @suppress("Avoid magic numbers")
+			/**
+			 * The size of the segment including the data of both rings
+			 */
+			static std::size_t getSize()
+			{
+				return sizeof( Segment) + 2 * segmentRingSize;
+			}
+	};
+
+	namespace
+	{
+		// The futex words are shared between processes, the atomics must be plain 32 bit words
+		static_assert(	sizeof( std::atomic< std::uint32_t >) == sizeof( std::uint32_t) && std::atomic< std::uint32_t >::is_always_lock_free,
+						"std::atomic< std::uint32_t > cannot be used as a futex");
+		/**
+		 * How long a side sleeps at most before it checks again whether the channel is closed
+		 */
+		const long waitTimeout = 100000000; // @suppress("Avoid magic numbers") 100 ms in ns
+		/**
+		 * The number of messages that may wait for the writer thread
+		 */
+		const std::size_t outgoingQueueCapacity = 1024; // @suppress("Avoid magic numbers")
+		/**
+		 * The number of messages the writer thread takes from the queue at once
+		 */
+		const std::size_t writeBatchSize = 16; // @suppress("Avoid magic numbers")
+#if defined(__linux__)
+		/**
+		 *
+		 */
+		void* mapSegment(	const std::string& aName,
+							bool aCreate,
+							std::size_t aSize)
+		{
+			const int fd = ::shm_open( aName.c_str(), aCreate ? O_RDWR | O_CREAT | O_EXCL : O_RDWR, 0600); // @suppress("Avoid magic numbers")
+			if (fd == -1)
+			{
+				return nullptr;
+			}
+			struct stat status;
+			if ((aCreate && ::ftruncate( fd, static_cast< off_t >( aSize)) == -1) || ::fstat( fd, &status) == -1
+							|| static_cast< std::size_t >( status.st_size) != aSize)
+			{
+				::close( fd);
+				if (aCreate)
+				{
+					::shm_unlink( aName.c_str());
+				}
+				return nullptr;
+			}
+			void* memory = ::mmap( nullptr, aSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			::close( fd);
+			if (memory == MAP_FAILED)
+			{
+				if (aCreate)
+				{
+					::shm_unlink( aName.c_str());
+				}
+				return nullptr;
+			}
+			return memory;
+		}
+		/**
+		 *
+		 */
+		void unmapSegment(	void* aMemory,
+							std::size_t aSize)
+		{
+			::munmap( aMemory, aSize);
+		}
+		/**
+		 *
+		 */
+		void unlinkSegment( const std::string& aName)
+		{
+			::shm_unlink( aName.c_str());
+		}
+		/**
+		 * Sleeps as long as aWord holds anExpectedValue, at most waitTimeout. Not FUTEX_PRIVATE: the
+		 * other side is another process.
+		 */
+		void futexWait(	std::atomic< std::uint32_t >& aWord,
+						std::uint32_t anExpectedValue)
+		{
+			const struct timespec timeout{ 0, waitTimeout};
+			::syscall( SYS_futex, reinterpret_cast< std::uint32_t* >( &aWord), FUTEX_WAIT, anExpectedValue, &timeout, nullptr, 0);
+		}
+		/**
+		 *
+		 */
+		void futexWake( std::atomic< std::uint32_t >& aWord)
+		{
+			::syscall( SYS_futex, reinterpret_cast< std::uint32_t* >( &aWord), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+		}
+		/**
+		 *
+		 */
+		std::string makeSegmentName( unsigned long aCounter)
+		{
+			return "/robotworld-" + std::to_string( ::getpid()) + "-" + std::to_string( aCounter);
+		}
+#else
+		void* mapSegment(	const std::string& UNUSEDPARAM(aName),
+							bool UNUSEDPARAM(aCreate),
+							std::size_t UNUSEDPARAM(aSize))
+		{
+			return nullptr;
+		}
+		void unmapSegment(	void* UNUSEDPARAM(aMemory),
+							std::size_t UNUSEDPARAM(aSize))
+		{
+		}
+		void unlinkSegment( const std::string& UNUSEDPARAM(aName))
+		{
+		}
+		void futexWait(	std::atomic< std::uint32_t >& UNUSEDPARAM(aWord),
+						std::uint32_t UNUSEDPARAM(anExpectedValue))
+		{
+		}
+		void futexWake( std::atomic< std::uint32_t >& UNUSEDPARAM(aWord))
+		{
+		}
+		std::string makeSegmentName( unsigned long aCounter)
+		{
+			return "/robotworld-" + std::to_string( aCounter);
+		}
+#endif
+	} // namespace
+
+	/* static */std::atomic< unsigned long > SharedMemoryChannel::segmentCounter( 0);
+	/**
+	 *
+	 */
+	/* static */bool SharedMemoryChannel::isSupported()
+	{
+#if defined(__linux__)
+		return true;
+#else
+		return false;
+#endif
+	}
+	/**
+	 *
+	 */
+	/* static */SharedMemoryChannelPtr SharedMemoryChannel::create()
+	{
+		if (!isSupported())
+		{
+			return nullptr;
+		}
+		const std::string name = makeSegmentName( ++segmentCounter);
+		void* memory = mapSegment( name, true, Segment::getSize());
+		if (!memory)
+		{
+			TRACE_DEVELOP( "*** SharedMemoryChannel::create: cannot create " + name + ": " + std::strerror( errno));
+			return nullptr;
+		}
+		return SharedMemoryChannelPtr( new SharedMemoryChannel( name, new (memory) Segment(), true));
+	}
+	/**
+	 *
+	 */
+	/* static */SharedMemoryChannelPtr SharedMemoryChannel::open( const std::string& aName)
+	{
+		if (!isSupported() || aName.compare( 0, 12, "/robotworld-") != 0) // @suppress("Avoid magic numbers")
+		{
+			return nullptr;
+		}
+		void* memory = mapSegment( aName, false, Segment::getSize());
+		if (!memory)
+		{
+			TRACE_DEVELOP( "*** SharedMemoryChannel::open: cannot open " + aName + ": " + std::strerror( errno));
+			return nullptr;
+		}
+		Segment* segment = static_cast< Segment* >( memory);
+		if (segment->magic != Segment::segmentMagic || segment->ringSize != Segment::segmentRingSize)
+		{
+			TRACE_DEVELOP( "*** SharedMemoryChannel::open: " + aName + " is not a channel");
+			unmapSegment( memory, Segment::getSize());
+			return nullptr;
+		}
+		return SharedMemoryChannelPtr( new SharedMemoryChannel( aName, segment, false));
+	}
+	/**
+	 *
+	 */
+	SharedMemoryChannel::SharedMemoryChannel(	const std::string& aName,
+												Segment* aSegment,
+												bool aCreator) :
+													name( aName),
+													segment( aSegment),
+													incoming( &aSegment->rings[aCreator ? 1 : 0]),
+													outgoing( &aSegment->rings[aCreator ? 0 : 1]),
+													incomingData( reinterpret_cast< char* >( aSegment + 1) + (aCreator ? Segment::segmentRingSize : 0)),
+													outgoingData( reinterpret_cast< char* >( aSegment + 1) + (aCreator ? 0 : Segment::segmentRingSize)),
+													creator( aCreator),
+													outgoingMessages( outgoingQueueCapacity)
+	{
+		writerThread = std::thread( &SharedMemoryChannel::writeMessages, this);
+	}
+	/**
+	 *
+	 */
+	SharedMemoryChannel::~SharedMemoryChannel()
+	{
+		close();
+		writerThread.join();
+		if (creator)
+		{
+			unlink();
+		}
+		unmapSegment( segment, Segment::getSize());
+	}
+	/**
+	 *
+	 */
+	void SharedMemoryChannel::unlink()
+	{
+		unlinkSegment( name);
+	}
+	/**
+	 *
+	 */
+	bool SharedMemoryChannel::writeMessage( const Message& aMessage)
+	{
+		return !isClosed() && outgoingMessages.enqueue( aMessage);
+	}
+	/**
+	 *
+	 */
+	bool SharedMemoryChannel::tryWriteMessage( const Message& aMessage)
+	{
+		return !isClosed() && outgoingMessages.tryEnqueue( aMessage);
+	}
+	/**
+	 *
+	 */
+	bool SharedMemoryChannel::readMessage( Message& aMessage)
+	{
+		char buffer[Message::MessageHeader::binaryHeaderLength];
+		if (!read( buffer, sizeof( buffer)))
+		{
+			return false;
+		}
+		Message::MessageHeader header;
+		if (!header.decode( buffer))
+		{
+			TRACE_DEVELOP( "*** SharedMemoryChannel::readMessage: invalid header on " + name);
+			close();
+			return false;
+		}
+		if (header.getMessageLength() > Message::MessageHeader::maxMessageLength)
+		{
+			TRACE_DEVELOP( "*** SharedMemoryChannel::readMessage: message length " + std::to_string( header.getMessageLength()) + " exceeds the maximum on " + name);
+			close();
+			return false;
+		}
+		// setHeader only resizes the body, the body is read in place
+		aMessage.setHeader( header);
+		return aMessage.message.empty() || read( &aMessage.message[0], aMessage.message.length());
+	}
+	/**
+	 *
+	 */
+	void SharedMemoryChannel::close()
+	{
+		segment->closed.store( 1);
+		for (Ring& ring : segment->rings)
+		{
+			futexWake( ring.head);
+			futexWake( ring.tail);
+		}
+		outgoingMessages.shutDown();
+	}
+	/**
+	 *
+	 */
+	bool SharedMemoryChannel::isClosed() const
+	{
+		return segment->closed.load() != 0;
+	}
+	/**
+	 *
+	 */
+	void SharedMemoryChannel::writeMessages()
+	{
+		std::vector< Message > messages( writeBatchSize);
+		while (std::size_t count = outgoingMessages.dequeue( messages.data(), messages.size()))
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				char header[Message::MessageHeader::binaryHeaderLength];
+				messages[i].getHeader().encode( header);
+				if (!write( header, sizeof( header)) || !write( messages[i].message.data(), messages[i].message.length()))
+				{
+					// Also wakes the writers that wait for room in the queue
+					close();
+					return;
+				}
+				messages[i] = Message();
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	bool SharedMemoryChannel::write(	const char* aBuffer,
+										std::size_t aLength)
+	{
+		const std::uint32_t ringSize = Segment::segmentRingSize;
+		while (aLength > 0)
+		{
+			if (isClosed())
+			{
+				return false;
+			}
+			const std::uint32_t tail = outgoing->tail.load( std::memory_order_relaxed);
+			std::uint32_t head = outgoing->head.load( std::memory_order_acquire);
+			if (tail - head == ringSize)
+			{
+				// Announce the wait before checking again, a reader that frees space after the check sees the announcement
+				outgoing->writerWaiting.store( 1);
+				head = outgoing->head.load();
+				if (tail - head == ringSize && !isClosed())
+				{
+					futexWait( outgoing->head, head);
+				}
+				outgoing->writerWaiting.store( 0);
+				continue;
+			}
+
+			const std::uint32_t length = static_cast< std::uint32_t >( std::min< std::size_t >( ringSize - (tail - head), aLength));
+			const std::uint32_t offset = tail & (ringSize - 1);
+			const std::uint32_t first = std::min( length, ringSize - offset);
+			std::memcpy( outgoingData + offset, aBuffer, first);
+			std::memcpy( outgoingData, aBuffer + first, length - first);
+			outgoing->tail.store( tail + length);
+			if (outgoing->readerWaiting.load())
+			{
+				futexWake( outgoing->tail);
+			}
+			aBuffer += length;
+			aLength -= length;
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	bool SharedMemoryChannel::read(	char* aBuffer,
+									std::size_t aLength)
+	{
+		const std::uint32_t ringSize = Segment::segmentRingSize;
+		while (aLength > 0)
+		{
+			const std::uint32_t head = incoming->head.load( std::memory_order_relaxed);
+			std::uint32_t tail = incoming->tail.load( std::memory_order_acquire);
+			if (tail == head)
+			{
+				// Whatever the peer wrote before it closed is not of interest anymore
+				if (isClosed())
+				{
+					return false;
+				}
+				incoming->readerWaiting.store( 1);
+				tail = incoming->tail.load();
+				if (tail == head && !isClosed())
+				{
+					futexWait( incoming->tail, tail);
+				}
+				incoming->readerWaiting.store( 0);
+				continue;
+			}
+
+			const std::uint32_t length = static_cast< std::uint32_t >( std::min< std::size_t >( tail - head, aLength));
+			const std::uint32_t offset = head & (ringSize - 1);
+			const std::uint32_t first = std::min( length, ringSize - offset);
+			std::memcpy( aBuffer, incomingData + offset, first);
+			std::memcpy( aBuffer + first, incomingData, length - first);
+			incoming->head.store( head + length);
+			if (incoming->writerWaiting.load())
+			{
+				futexWake( incoming->head);
+			}
+			aBuffer += length;
+			aLength -= length;
+		}
+		return true;
+	}
+} // namespace Messaging
@@ -0,0 +1,157 @@
+#ifndef SHAREDMEMORYCHANNEL_HPP_
+#define SHAREDMEMORYCHANNEL_HPP_
+
+#include "Config.hpp"
+
+#include "Message.hpp"
+#include "Queue.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace Messaging
+{
+	/**
+	 * Two byte rings in a POSIX shared memory segment, one per direction, between two processes on
+	 * the same host. Each ring has exactly one writing and one reading process.
+	 *
+	 * The messages are written as the same frames as on a socket, the binary header followed by the
+	 * body, straight from the Message into the ring and from the ring into the Message on the other
+	 * side. No kernel buffer is involved. A side that has to wait, for data or for free space,
+	 * sleeps on a futex on the index of the other side, which the other side only wakes if somebody
+	 * waits, so a busy channel does not make system calls at all.
+	 *
+	 * The messages are written to the ring by a thread of the channel, the writers only queue them.
+	 * A peer that stops reading therefore never blocks the simulation or an io thread, their writes
+	 * fail as soon as the queue is full.
+	 *
+	 * The client creates the segment, the server opens it by name. Once both have it mapped the client
+	 * unlinks the name, so a crash does not leave it behind.
+	 *
+	 * Only available on Linux, see isSupported().
+	 */
+	class SharedMemoryChannel
+	{
+		public:
+			/**
+			 * @return true if channels can be created on this platform
+			 */
+			static bool isSupported();
+			/**
+			 * Creates a new segment with a unique name, for the client side
+			 *
+			 * @return nullptr if the segment could not be created
+			 */
+			static std::shared_ptr< SharedMemoryChannel > create();
+			/**
+			 * Opens the segment that a client created, for the server side
+			 *
+			 * @return nullptr if the segment could not be opened or is not a channel
+			 */
+			static std::shared_ptr< SharedMemoryChannel > open( const std::string& aName);
+			/**
+			 *
+			 */
+			~SharedMemoryChannel();
+			/**
+			 *
+			 */
+			SharedMemoryChannel( const SharedMemoryChannel& aChannel) = delete;
+			/**
+			 *
+			 */
+			SharedMemoryChannel& operator=( const SharedMemoryChannel& aChannel) = delete;
+			/**
+			 *
+			 */
+			const std::string& getName() const
+			{
+				return name;
+			}
+			/**
+			 * Removes the name of the segment, the mappings stay valid
+			 */
+			void unlink();
+			/**
+			 * Queues aMessage for the peer, waits as long as the queue is full. Only for threads that
+			 * may wait for the peer. May be called from any thread.
+			 *
+			 * @return false if the channel is closed
+			 */
+			bool writeMessage( const Message& aMessage);
+			/**
+			 * Queues aMessage for the peer, never waits. May be called from any thread.
+			 *
+			 * @return false if the channel is closed or the queue is full
+			 */
+			bool tryWriteMessage( const Message& aMessage);
+			/**
+			 * Waits for the next message of the peer. Must always be called from the same thread.
+			 *
+			 * @return false if the channel is closed or the peer wrote garbage, e.g. a message longer
+			 * than Message::MessageHeader::maxMessageLength, which closes the channel
+			 */
+			bool readMessage( Message& aMessage);
+			/**
+			 * Closes the channel for both sides, readMessage and writeMessage return false from now on.
+			 * May be called from any thread.
+			 */
+			void close();
+			/**
+			 *
+			 */
+			bool isClosed() const;
+
+		private:
+			struct Segment;
+			struct Ring;
+			/**
+			 *
+			 */
+			SharedMemoryChannel(	const std::string& aName,
+									Segment* aSegment,
+									bool aCreator);
+			/**
+			 * The body of writerThread: moves the queued messages into the outgoing ring until the
+			 * channel is closed
+			 */
+			void writeMessages();
+			/**
+			 * Copies aLength bytes into the outgoing ring, in pieces if the ring is smaller
+			 */
+			bool write(	const char* aBuffer,
+						std::size_t aLength);
+			/**
+			 * Copies aLength bytes out of the incoming ring
+			 */
+			bool read(	char* aBuffer,
+						std::size_t aLength);
+			/**
+			 *
+			 */
+			std::string name;
+			Segment* segment;
+			Ring* incoming;
+			Ring* outgoing;
+			char* incomingData;
+			char* outgoingData;
+			bool creator;
+			/**
+			 * The messages that wait for writerThread
+			 */
+			Base::Queue< Message > outgoingMessages;
+			std::thread writerThread;
+			/**
+			 * The counter for the unique names of the segments of this process
+			 */
+			static std::atomic< unsigned long > segmentCounter;
+	};
+	// class SharedMemoryChannel
+	typedef std::shared_ptr< SharedMemoryChannel > SharedMemoryChannelPtr;
+} // namespace Messaging
+
+#endif // SHAREDMEMORYCHANNEL_HPP_
@@ -0,0 +1,111 @@
+#include "SharedMemorySession.hpp"
+
+#include "Message.hpp"
+#include "MessageTypes.hpp"
+#include "Trace.hpp"
+
+#include <thread>
+
+namespace Messaging
+{
+	/**
+	 *
+	 */
+	SharedMemorySession::SharedMemorySession(	SharedMemoryChannelPtr aChannel,
+												RequestHandlerPtr aRequestHandler) :
+													channel( aChannel),
+													requestHandler( aRequestHandler)
+	{
+	}
+	/**
+	 *
+	 */
+	void SharedMemorySession::start()
+	{
+		// The thread keeps the session alive until the channel is closed
+		SharedMemorySessionPtr self = shared_from_this();
+		std::thread thread( [self]()
+		{
+			self->handleRequests();
+		});
+		thread.detach();
+	}
+	/**
+	 *
+	 */
+	void SharedMemorySession::stop()
+	{
+		channel->close();
+	}
+	/**
+	 *
+	 */
+	void SharedMemorySession::handleRequests()
+	{
+		// The handlers run on this thread and not on the Base::ThreadPool: it is not an io thread
+		// and the next request has to wait for the response anyway
+		Message message;
+		while (channel->readMessage( message))
+		{
+			// A handler that throws must not end the thread, the client still gets a response
+			try
+			{
+				if (message.isStream())
+				{
+					requestHandler->handleSubscription( message, std::make_shared< SharedMemorySubscription >( channel, message.getCorrelationId()));
+				} else
+				{
+					requestHandler->handleRequest( message);
+				}
+			}
+			catch (std::exception& e)
+			{
+				setExceptionResponse( message, e.what());
+			}
+			catch (...)
+			{
+				setExceptionResponse( message, "unknown exception");
+			}
+			if (!channel->writeMessage( message))
+			{
+				break;
+			}
+		}
+		TRACE_DEVELOP( "SharedMemorySession::handleRequests: " + channel->getName() + " closed");
+	}
+	/**
+	 *
+	 */
+	/* static */void SharedMemorySession::setExceptionResponse(	Message& aMessage,
+																const std::string& aWhat)
+	{
+		TRACE_DEVELOP( "*** SharedMemorySession: request handler failed on " + aMessage.asString() + ": " + aWhat);
+		aMessage.setMessageType( ServerSideExceptionResponse);
+		aMessage.setFlags( static_cast< unsigned char >( aMessage.getFlags() & ~Message::Stream));
+		aMessage.setBody( aWhat);
+	}
+	/**
+	 *
+	 */
+	bool SharedMemorySubscription::publish( const Message& aMessage)
+	{
+		if (overrun.load())
+		{
+			return false;
+		}
+		Message published( aMessage);
+		published.setCorrelationId( correlationId);
+		published.setFlags( published.getFlags() | Message::Stream);
+		// Never wait for a subscriber that does not keep up, the publisher is the simulation
+		if (!channel->tryWriteMessage( published))
+		{
+			if (!channel->isClosed())
+			{
+				TRACE_DEVELOP( "*** SharedMemorySubscription::publish: " + channel->getName() + " is full, ending the subscription");
+			}
+			overrun.store( true);
+			return false;
+		}
+		return true;
+	}
+} // namespace Messaging
@@ -0,0 +1,105 @@
+#ifndef SHAREDMEMORYSESSION_HPP_
+#define SHAREDMEMORYSESSION_HPP_
+
+#include "Config.hpp"
+
+#include "MessageHandler.hpp"
+#include "SharedMemoryChannel.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace Messaging
+{
+	/**
+	 * The server side of a Connection that switched to a SharedMemoryChannel.
+	 *
+	 * A thread of its own waits for the requests, hands them to the request handler one at a
+	 * time, in the order they arrive like a ServerSession does, and writes the responses back. The
+	 * ServerSession that accepted the channel keeps the socket open and stops this session when the
+	 * client goes away.
+	 */
+	class SharedMemorySession : public std::enable_shared_from_this< SharedMemorySession >
+	{
+		public:
+			/**
+			 *
+			 */
+			SharedMemorySession(	SharedMemoryChannelPtr aChannel,
+									RequestHandlerPtr aRequestHandler);
+			/**
+			 *
+			 */
+			virtual ~SharedMemorySession() = default;
+			/**
+			 * Starts the thread that handles the requests
+			 */
+			void start();
+			/**
+			 * Closes the channel, the thread ends as soon as the request handler returns
+			 */
+			void stop();
+
+		private:
+			/**
+			 *
+			 */
+			void handleRequests();
+			/**
+			 * Turns aMessage into a final ServerSideExceptionResponse for a request handler that threw
+			 */
+			static void setExceptionResponse(	Message& aMessage,
+												const std::string& aWhat);
+			/**
+			 *
+			 */
+			SharedMemoryChannelPtr channel;
+			/**
+			 *
+			 */
+			RequestHandlerPtr requestHandler;
+	};
+	// class SharedMemorySession
+	typedef std::shared_ptr< SharedMemorySession > SharedMemorySessionPtr;
+	/**
+	 * A Subscription on a SharedMemorySession, the published messages are queued on the channel.
+	 * The subscription ends when the subscriber does not keep up and the queue is full.
+	 */
+	class SharedMemorySubscription : public Subscription
+	{
+		public:
+			/**
+			 *
+			 */
+			SharedMemorySubscription(	SharedMemoryChannelPtr aChannel,
+										unsigned long aCorrelationId) :
+											channel( aChannel),
+											correlationId( aCorrelationId),
+											overrun( false)
+			{
+			}
+			/**
+			 * @see Subscription::publish( const Message& aMessage)
+			 */
+			virtual bool publish( const Message& aMessage) override;
+			/**
+			 * @see Subscription::isActive()
+			 */
+			virtual bool isActive() const override
+			{
+				return !overrun.load() && !channel->isClosed();
+			}
+
+		private:
+			SharedMemoryChannelPtr channel;
+			unsigned long correlationId;
+			/**
+			 * Set when a message did not fit in the channel anymore, the subscriber missed it
+			 */
+			std::atomic< bool > overrun;
+	};
+	// class SharedMemorySubscription
+} // namespace Messaging
+
+#endif // SHAREDMEMORYSESSION_HPP_
@@ -0,0 +1,192 @@
+#include "SimulationScheduler.hpp"
+
+#include "Clock.hpp"
+#include "Logger.hpp"
+#include "Robot.hpp"
+#include "RobotWorld.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace Model
+{
+	/**
+	 *
+	 */
+	/* static */SimulationScheduler& SimulationScheduler::getSimulationScheduler()
+	{
+		static SimulationScheduler simulationScheduler;
+		return simulationScheduler;
+	}
+	/**
+	 *
+	 */
+	void SimulationScheduler::addRobot( RobotPtr aRobot)
+	{
+		{
+			std::lock_guard< std::recursive_mutex > lock( schedulerMutex);
+			startingRobots.push_back( aRobot);
+		}
+		start();
+	}
+	/**
+	 *
+	 */
+	void SimulationScheduler::removeRobot( const Base::ObjectId& anObjectId)
+	{
+		std::lock_guard< std::recursive_mutex > lock( schedulerMutex);
+
+		auto hasObjectId = [&anObjectId](const RobotPtr& aRobot){ return aRobot->getObjectId() == anObjectId;};
+		startingRobots.erase( std::remove_if( startingRobots.begin(), startingRobots.end(), hasObjectId), startingRobots.end());
+		activeRobots.erase( std::remove_if( activeRobots.begin(), activeRobots.end(), hasObjectId), activeRobots.end());
+	}
+	/**
+	 *
+	 */
+	std::chrono::milliseconds SimulationScheduler::getTickInterval() const
+	{
+		return std::chrono::milliseconds( tickInterval);
+	}
+	/**
+	 *
+	 */
+	void SimulationScheduler::setTickInterval( const std::chrono::milliseconds& aTickInterval)
+	{
+		tickInterval = aTickInterval.count();
+	}
+	/**
+	 *
+	 */
+	void SimulationScheduler::start()
+	{
+		if (running.exchange( true))
+		{
+			return;
+		}
+		if (schedulerThread.joinable())
+		{
+			schedulerThread.join();
+		}
+		schedulerThread = std::thread( [this]{ run();});
+	}
+	/**
+	 *
+	 */
+	void SimulationScheduler::stop()
+	{
+		running = false;
+		if (schedulerThread.joinable() && schedulerThread.get_id() != std::this_thread::get_id())
+		{
+			schedulerThread.join();
+		}
+	}
+	/**
+	 *
+	 */
+	SimulationScheduler::SimulationScheduler() :
+								tickInterval( 100), // @suppress("Avoid magic numbers")
+								tickCount( 0),
+								running( false)
+	{
+		// The ticks use the pool, so it must be constructed first in order to be destroyed after the scheduler
+		Base::ThreadPool::getThreadPool();
+	}
+	/**
+	 *
+	 */
+	SimulationScheduler::~SimulationScheduler()
+	{
+		stop();
+	}
+	/**
+	 *
+	 */
+	void SimulationScheduler::run()
+	{
+		Base::Clock& clock = Base::Clock::getClock();
+		Base::Clock::TimePoint nextTick = clock.now();
+		while (running)
+		{
+			try
+			{
+				tick();
+			}
+			catch (std::exception& e)
+			{
+				Application::Logger::log( __PRETTY_FUNCTION__ + std::string( ": ") + e.what());
+				std::cerr << __PRETTY_FUNCTION__ << ": " << e.what() << std::endl;
+			}
+
+			// Fixed time step: the next tick is relative to the previous one, not to the end of this
+			// one. If a tick overran we do not try to catch up with a burst of ticks.
+			nextTick += getTickInterval();
+			Base::Clock::TimePoint now = clock.now();
+			if (nextTick < now)
+			{
+				nextTick = now;
+			}
+			clock.sleepUntil( nextTick);
+		}
+	}
+	/**
+	 *
+	 */
+	void SimulationScheduler::tick()
+	{
+		std::lock_guard< std::recursive_mutex > lock( schedulerMutex);
+
+		// Starting a robot starts the calculation of its route on the ThreadPool, the robot holds
+		// its position until the route is there, in virtual time this tick waits for it
+		std::vector< RobotPtr > newRobots;
+		newRobots.swap( startingRobots);
+		for (RobotPtr robot : newRobots)
+		{
+			if (robot->isActing())
+			{
+				robot->startDriving();
+				activeRobots.push_back( robot);
+			}
+		}
+
+		// In virtual time the ticks do not wait for the wall clock, so they would overtake the route
+		// calculations by a number of ticks that depends on the machine. Wait for them instead.
+		if (Base::Clock::getClock().getMode() == Base::Clock::VirtualTime)
+		{
+			for (RobotPtr robot : activeRobots)
+			{
+				robot->waitForRoute();
+			}
+		}
+
+		std::vector< RobotPtr > steppedRobots;
+		for (RobotPtr robot : activeRobots)
+		{
+			if (robot->isDriving())
+			{
+				robot->drive();
+				steppedRobots.push_back( robot);
+			}
+		}
+
+		RobotWorld& robotWorld = RobotWorld::getRobotWorld();
+		activeRobots.erase( std::remove_if( activeRobots.begin(),
+											activeRobots.end(),
+											[&robotWorld](const RobotPtr& aRobot)
+											{
+												return !aRobot->isDriving() || !robotWorld.getRobot( aRobot->getObjectId());
+											}),
+							activeRobots.end());
+
+		++tickCount;
+
+		// One notification per robot that moved in this tick. The views only record which robot changed,
+		// the canvas picks up all changes of a frame in one go. Subscribers in another robot world get
+		// at most one pose update per robot per tick as well.
+		for (RobotPtr robot : steppedRobots)
+		{
+			robot->notifyObservers();
+			robot->publishPose();
+		}
+	}
+} // namespace Model
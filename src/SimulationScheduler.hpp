@@ -0,0 +1,129 @@
+#ifndef SIMULATIONSCHEDULER_HPP_
+#define SIMULATIONSCHEDULER_HPP_
+
+#include "Config.hpp"
+
+#include "ObjectId.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Model
+{
+	class Robot;
+	typedef std::shared_ptr< Robot > RobotPtr;
+
+	/**
+	 * The SimulationScheduler owns the world tick. One thread advances all acting robots by one
+	 * step per tick at a fixed rate and sends one notification for the whole world per tick,
+	 * instead of every robot running its own sleeping thread and notifying on every step.
+	 *
+	 * A robot that is added is started (i.e. its route is calculated) on the next tick. A robot
+	 * is dropped as soon as it stops driving or is no longer part of the RobotWorld.
+	 *
+	 * In virtual time a tick first waits for the route calculations of its robots, so a run is
+	 * reproducible.
+	 */
+	class SimulationScheduler
+	{
+		public:
+			/**
+			 *
+			 */
+			static SimulationScheduler& getSimulationScheduler();
+			/**
+			 * Schedules aRobot, the scheduler thread is started if it is not running yet
+			 */
+			void addRobot( RobotPtr aRobot);
+			/**
+			 * Removes the robot. If a tick is in progress this waits until it is done so the robot
+			 * is guaranteed not to be stepped anymore when this returns.
+			 */
+			void removeRobot( const Base::ObjectId& anObjectId);
+			/**
+			 *
+			 */
+			std::chrono::milliseconds getTickInterval() const;
+			/**
+			 * Sets the time between 2 ticks, the default is 100 ms
+			 */
+			void setTickInterval( const std::chrono::milliseconds& aTickInterval);
+			/**
+			 *
+			 */
+			unsigned long long getTickCount() const
+			{
+				return tickCount;
+			}
+			/**
+			 *
+			 */
+			void start();
+			/**
+			 * Stops the scheduler thread, the scheduled robots are kept
+			 */
+			void stop();
+			/**
+			 *
+			 */
+			bool isRunning() const
+			{
+				return running;
+			}
+
+		protected:
+			/**
+			 *
+			 */
+			SimulationScheduler();
+			/**
+			 *
+			 */
+			virtual ~SimulationScheduler();
+			/**
+			 * The body of the scheduler thread
+			 */
+			void run();
+			/**
+			 * Advances all scheduled robots by one step
+			 */
+			void tick();
+
+		private:
+			/**
+			 * Guards the robot lists and is held for the duration of a tick. It is recursive
+			 * because a robot may stop itself, and so call removeRobot, from within its step.
+			 */
+			mutable std::recursive_mutex schedulerMutex;
+			/**
+			 * Robots that still have to be started
+			 */
+			std::vector< RobotPtr > startingRobots;
+			/**
+			 * Robots that are stepped every tick
+			 */
+			std::vector< RobotPtr > activeRobots;
+			/**
+			 * In milliseconds
+			 */
+			std::atomic< long long > tickInterval;
+			/**
+			 *
+			 */
+			std::atomic< unsigned long long > tickCount;
+			/**
+			 *
+			 */
+			std::atomic< bool > running;
+			/**
+			 *
+			 */
+			std::thread schedulerThread;
+	};
+	// class SimulationScheduler
+} // namespace Model
+#endif // SIMULATIONSCHEDULER_HPP_
@@ -0,0 +1,80 @@
+#include "SymbolTable.hpp"
+
+#include <stdexcept>
+
+namespace Base
+{
+	/**
+	 *
+	 */
+	/* static */SymbolId SymbolTable::intern( const std::string& aName)
+	{
+		SymbolId symbolId;
+		if (find( aName, symbolId))
+		{
+			return symbolId;
+		}
+
+		SymbolTable& symbolTable = getSymbolTable();
+		std::unique_lock< std::shared_mutex > lock( symbolTable.symbolTableMutex);
+
+		// Another thread may have interned aName after the find above
+		auto i = symbolTable.symbols.find( aName);
+		if (i != symbolTable.symbols.end())
+		{
+			return i->second;
+		}
+
+		symbolId = static_cast< SymbolId >(symbolTable.names.size());
+		symbolTable.names.push_back( aName);
+		symbolTable.symbols.emplace( aName, symbolId);
+		return symbolId;
+	}
+	/**
+	 *
+	 */
+	/* static */bool SymbolTable::find(	const std::string& aName,
+										SymbolId& aSymbolId)
+	{
+		SymbolTable& symbolTable = getSymbolTable();
+		std::shared_lock< std::shared_mutex > lock( symbolTable.symbolTableMutex);
+
+		auto i = symbolTable.symbols.find( aName);
+		if (i == symbolTable.symbols.end())
+		{
+			return false;
+		}
+		aSymbolId = i->second;
+		return true;
+	}
+	/**
+	 *
+	 */
+	/* static */const std::string& SymbolTable::getName( SymbolId aSymbolId)
+	{
+		SymbolTable& symbolTable = getSymbolTable();
+		std::shared_lock< std::shared_mutex > lock( symbolTable.symbolTableMutex);
+
+		if (aSymbolId >= symbolTable.names.size())
+		{
+			throw std::out_of_range( "SymbolTable::getName: unknown symbol");
+		}
+		return symbolTable.names[aSymbolId];
+	}
+	/**
+	 *
+	 */
+	SymbolTable::SymbolTable()
+	{
+		names.push_back( "");
+		symbols.emplace( "", EmptySymbol);
+	}
+	/**
+	 *
+	 */
+	/* static */SymbolTable& SymbolTable::getSymbolTable()
+	{
+		static SymbolTable symbolTable;
+		return symbolTable;
+	}
+} // namespace Base
@@ -0,0 +1,75 @@
+#ifndef SYMBOLTABLE_HPP_
+#define SYMBOLTABLE_HPP_
+
+#include "Config.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Base
+{
+	/**
+	 * An interned name. Two SymbolIds are equal if and only if the names they were interned from are equal.
+	 */
+	typedef std::uint32_t SymbolId;
+
+	/**
+	 * Interns names into small integer ids so hot code can compare and hash integers
+	 * instead of strings. Symbols are never removed, the names are stable for the life
+	 * time of the program. All functions are thread safe.
+	 */
+	class SymbolTable
+	{
+		public:
+			/**
+			 * The id of the empty name
+			 */
+			static constexpr SymbolId EmptySymbol = 0;
+			/**
+			 *
+			 * @return the id of aName, a new id is allocated if aName was never seen before
+			 */
+			static SymbolId intern( const std::string& aName);
+			/**
+			 * Looks aName up without interning it, use this for names that come from outside
+			 * the program so unknown names do not grow the table
+			 *
+			 * @return true and the id of aName in aSymbolId if aName was interned before
+			 */
+			static bool find(	const std::string& aName,
+								SymbolId& aSymbolId);
+			/**
+			 *
+			 * @return the name that was interned as aSymbolId
+			 */
+			static const std::string& getName( SymbolId aSymbolId);
+
+		private:
+			/**
+			 *
+			 */
+			SymbolTable();
+			/**
+			 *
+			 */
+			static SymbolTable& getSymbolTable();
+			/**
+			 *
+			 */
+			std::shared_mutex symbolTableMutex;
+			/**
+			 * Index is the SymbolId. A deque keeps the references returned by getName valid.
+			 */
+			std::deque< std::string > names;
+			/**
+			 *
+			 */
+			std::unordered_map< std::string, SymbolId > symbols;
+	};
+	// class SymbolTable
+} // namespace Base
+#endif // SYMBOLTABLE_HPP_
@@ -0,0 +1,82 @@
+#ifndef TELEMETRYDATAGRAM_HPP_
+#define TELEMETRYDATAGRAM_HPP_
+
+#include "Config.hpp"
+
+#include "ByteOrder.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Messaging
+{
+	/**
+	 * The layout of a telemetry datagram, all numbers little-endian:
+	 *
+	 *  offset  size  field
+	 *       0     2  magic, the bytes 'R' 'T'
+	 *       2     1  version (1)
+	 *       3     1  number of messages in the datagram
+	 *       4     4  epoch of the sender, a random number that changes when the sender is created again
+	 *       8     4  sequence number of the datagram within the epoch
+	 *      12        the messages, each:
+	 *                   1  message type
+	 *                   2  length of the body
+	 *                   n  body
+	 *
+	 * A datagram is never larger than maxLength, which fits in the MTU of an ethernet link, so
+	 * a datagram is never fragmented and either arrives as a whole or not at all.
+	 */
+	struct TelemetryDatagram
+	{
+			/**
+			 *
+			 */
+			static void encodeHeader(	char* aBuffer,
+										std::uint8_t aNumberOfMessages,
+										std::uint32_t anEpoch,
+										std::uint32_t aSequenceNumber)
+			{
+				Base::storeLittleEndian( aBuffer, magic);
+				aBuffer[2] = version;
+				aBuffer[3] = static_cast< char >( aNumberOfMessages);
+				Base::storeLittleEndian( aBuffer + 4, anEpoch); // @suppress("Avoid magic numbers")
+				Base::storeLittleEndian( aBuffer + 8, aSequenceNumber); // @suppress("Avoid magic numbers")
+			}
+			/**
+			 * @return false if aBuffer does not start with a header of a known version
+			 */
+			static bool decodeHeader(	const char* aBuffer,
+										std::size_t aLength,
+										std::uint8_t& aNumberOfMessages,
+										std::uint32_t& anEpoch,
+										std::uint32_t& aSequenceNumber)
+			{
+				if (aLength < headerLength || Base::loadLittleEndian< std::uint16_t >( aBuffer) != magic || aBuffer[2] != version)
+				{
+					return false;
+				}
+				aNumberOfMessages = static_cast< std::uint8_t >( aBuffer[3]);
+				anEpoch = Base::loadLittleEndian< std::uint32_t >( aBuffer + 4); // @suppress("Avoid magic numbers")
+				aSequenceNumber = Base::loadLittleEndian< std::uint32_t >( aBuffer + 8); // @suppress("Avoid magic numbers")
+				return true;
+			}
+			/**
+			 * @return true if aSequenceNumber comes after aPreviousSequenceNumber, also when the numbers wrapped around
+			 */
+			static bool isNewer(	std::uint32_t aSequenceNumber,
+									std::uint32_t aPreviousSequenceNumber)
+			{
+				return static_cast< std::int32_t >( aSequenceNumber - aPreviousSequenceNumber) > 0;
+			}
+
+			static const std::uint16_t magic = 0x5452; // 'R' 'T' in little-endian
+			static const char version = 1;
+			static const std::size_t headerLength = 12;
+			static const std::size_t messageHeaderLength = 3;
+			static const std::size_t maxLength = 1400;
+			static const std::size_t maxMessages = 255;
+	};
+	// struct TelemetryDatagram
+} // namespace Messaging
+#endif // TELEMETRYDATAGRAM_HPP_
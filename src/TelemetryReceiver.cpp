@@ -0,0 +1,163 @@
+#include "TelemetryReceiver.hpp"
+
+#include "CommunicationService.hpp"
+#include "Message.hpp"
+#include "TelemetryDatagram.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+namespace Messaging
+{
+	/**
+	 *
+	 */
+	TelemetryReceiver::TelemetryReceiver(	unsigned short aPort,
+											ResponseHandlerPtr aResponseHandler) :
+												port( aPort),
+												responseHandler( aResponseHandler),
+												socket( boost::asio::make_strand( CommunicationService::getCommunicationService().getIOContext())),
+												receiveBuffer( 65536), // @suppress("Avoid magic numbers")
+												handling( false)
+	{
+	}
+	/**
+	 *
+	 */
+	void TelemetryReceiver::start()
+	{
+		boost::asio::ip::udp::endpoint endpoint( boost::asio::ip::udp::v4(), port);
+		socket.open( endpoint.protocol());
+		socket.set_option( boost::asio::ip::udp::socket::reuse_address( true));
+		socket.bind( endpoint);
+
+		TelemetryReceiverPtr self = shared_from_this();
+		boost::asio::post(	socket.get_executor(), // @suppress("Invalid arguments")
+							[self]()
+							{
+								self->receive();
+							});
+	}
+	/**
+	 *
+	 */
+	void TelemetryReceiver::stop()
+	{
+		TelemetryReceiverPtr self = shared_from_this();
+		boost::asio::post(	socket.get_executor(), // @suppress("Invalid arguments")
+							[self]()
+							{
+								boost::system::error_code error;
+								self->socket.close( error);
+							});
+	}
+	/**
+	 *
+	 */
+	void TelemetryReceiver::receive()
+	{
+		TelemetryReceiverPtr self = shared_from_this();
+		socket.async_receive_from(	boost::asio::buffer( receiveBuffer), // @suppress("Invalid arguments")
+									senderEndpoint,
+									[self](const boost::system::error_code& error, std::size_t bytes_transferred)
+									{
+										if (error == boost::asio::error::operation_aborted || !self->socket.is_open())
+										{
+											return;
+										}
+										if (!error)
+										{
+											self->handleDatagram( bytes_transferred);
+										} else
+										{
+											// E.g. an ICMP port unreachable of an earlier send, the port itself is fine
+											TRACE_DEVELOP( "*** TelemetryReceiver::receive: " + error.message());
+										}
+										self->receive();
+									});
+	}
+	/**
+	 *
+	 */
+	void TelemetryReceiver::handleDatagram( std::size_t aLength)
+	{
+		std::uint8_t numberOfMessages;
+		std::uint32_t epoch;
+		std::uint32_t sequenceNumber;
+		if (!TelemetryDatagram::decodeHeader( receiveBuffer.data(), aLength, numberOfMessages, epoch, sequenceNumber))
+		{
+			TRACE_DEVELOP( "*** TelemetryReceiver::handleDatagram: not a telemetry datagram");
+			return;
+		}
+
+		auto result = senders.find( senderEndpoint);
+		if (result != senders.end() && result->second.epoch == epoch && !TelemetryDatagram::isNewer( sequenceNumber, result->second.sequenceNumber))
+		{
+			// Overtaken by a newer datagram, the values are stale
+			return;
+		}
+		senders[senderEndpoint] = Sender{ epoch, sequenceNumber};
+
+		std::vector< Message > messages;
+		std::size_t offset = TelemetryDatagram::headerLength;
+		for (std::uint8_t i = 0; i < numberOfMessages; ++i)
+		{
+			if (offset + TelemetryDatagram::messageHeaderLength > aLength)
+			{
+				break;
+			}
+			const char messageType = receiveBuffer[offset];
+			const std::size_t length = Base::loadLittleEndian< std::uint16_t >( &receiveBuffer[offset + 1]);
+			offset += TelemetryDatagram::messageHeaderLength;
+			if (offset + length > aLength)
+			{
+				TRACE_DEVELOP( "*** TelemetryReceiver::handleDatagram: truncated datagram");
+				break;
+			}
+
+			messages.push_back( Message( messageType, std::string( &receiveBuffer[offset], length)));
+			offset += length;
+		}
+		if (messages.empty())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard< std::mutex > lock( receivedMessagesBusy);
+			receivedMessages.insert( receivedMessages.end(), messages.begin(), messages.end());
+			if (handling)
+			{
+				return;
+			}
+			handling = true;
+		}
+		TelemetryReceiverPtr self = shared_from_this();
+		Base::ThreadPool::getThreadPool().submit( [self]()
+		{
+			self->handleMessages();
+		});
+	}
+	/**
+	 *
+	 */
+	void TelemetryReceiver::handleMessages()
+	{
+		for (;;)
+		{
+			std::deque< Message > messages;
+			{
+				std::lock_guard< std::mutex > lock( receivedMessagesBusy);
+				if (receivedMessages.empty())
+				{
+					handling = false;
+					return;
+				}
+				messages.swap( receivedMessages);
+			}
+			for (const Message& message : messages)
+			{
+				responseHandler->handleResponse( message);
+			}
+		}
+	}
+} // namespace Messaging
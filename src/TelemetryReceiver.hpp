@@ -0,0 +1,111 @@
+#ifndef TELEMETRYRECEIVER_HPP_
+#define TELEMETRYRECEIVER_HPP_
+
+#include "Config.hpp"
+
+#include "Message.hpp"
+#include "MessageHandler.hpp"
+
+#include <boost/asio.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Messaging
+{
+	/**
+	 * Receives the datagrams of TelemetrySenders on a UDP port and hands every message in them to
+	 * the ResponseHandler, on the Base::ThreadPool, as if it were a response. The messages are handled
+	 * one at a time in the order they were received, so a handler never sees an older value after a
+	 * newer one.
+	 *
+	 * A datagram that arrives after a newer datagram of the same sender is dropped: its values are
+	 * stale. A sender that is created again starts a new epoch and its sequence numbers start over.
+	 */
+	class TelemetryReceiver : public std::enable_shared_from_this< TelemetryReceiver >
+	{
+		public:
+			/**
+			 *
+			 */
+			TelemetryReceiver(	unsigned short aPort,
+								ResponseHandlerPtr aResponseHandler);
+			/**
+			 *
+			 */
+			virtual ~TelemetryReceiver() = default;
+			/**
+			 *
+			 */
+			unsigned short getPort() const
+			{
+				return port;
+			}
+			/**
+			 * Binds the port and starts receiving
+			 */
+			void start();
+			/**
+			 * Closes the port, may be called from any thread
+			 */
+			void stop();
+
+		private:
+			/**
+			 *
+			 */
+			void receive();
+			/**
+			 *
+			 */
+			void handleDatagram( std::size_t aLength);
+			/**
+			 * Hands the received messages to the response handler until there are none left, runs
+			 * on the Base::ThreadPool, only one at a time
+			 */
+			void handleMessages();
+			/**
+			 *
+			 */
+			struct Sender
+			{
+					std::uint32_t epoch;
+					std::uint32_t sequenceNumber;
+			};
+			/**
+			 *
+			 */
+			unsigned short port;
+			/**
+			 *
+			 */
+			ResponseHandlerPtr responseHandler;
+			/**
+			 *
+			 */
+			boost::asio::ip::udp::socket socket;
+			/**
+			 * Only used on the strand of the socket
+			 */
+			std::vector< char > receiveBuffer;
+			boost::asio::ip::udp::endpoint senderEndpoint;
+			std::map< boost::asio::ip::udp::endpoint, Sender > senders;
+			/**
+			 * Guards receivedMessages and handling
+			 */
+			std::mutex receivedMessagesBusy;
+			std::deque< Message > receivedMessages;
+			/**
+			 * True while a handleMessages task is submitted or running
+			 */
+			bool handling;
+	};
+	// class TelemetryReceiver
+	typedef std::shared_ptr< TelemetryReceiver > TelemetryReceiverPtr;
+} // namespace Messaging
+
+#endif // TELEMETRYRECEIVER_HPP_
@@ -0,0 +1,148 @@
+#include "TelemetrySender.hpp"
+
+#include "CommunicationService.hpp"
+#include "TelemetryDatagram.hpp"
+#include "Trace.hpp"
+
+#include <random>
+#include <sstream>
+
+namespace Messaging
+{
+	/**
+	 *
+	 */
+	TelemetrySender::TelemetrySender(	const std::string& aHostName,
+										unsigned short aPort) :
+											host( aHostName),
+											port( aPort),
+											socket( boost::asio::make_strand( CommunicationService::getCommunicationService().getIOContext())),
+											endpointResolved( false),
+											numberOfMessages( 0),
+											flushPosted( false),
+											sending( false),
+											epoch( std::random_device()()),
+											sequenceNumber( 0)
+	{
+		batch.reserve( TelemetryDatagram::maxLength);
+		batch.resize( TelemetryDatagram::headerLength);
+	}
+	/**
+	 *
+	 */
+	bool TelemetrySender::send( const Message& aMessage)
+	{
+		const std::size_t length = TelemetryDatagram::messageHeaderLength + aMessage.length();
+		if (TelemetryDatagram::headerLength + length > TelemetryDatagram::maxLength)
+		{
+			return false;
+		}
+
+		std::lock_guard< std::mutex > lock( batchBusy);
+		if (batch.size() + length > TelemetryDatagram::maxLength || numberOfMessages == TelemetryDatagram::maxMessages)
+		{
+			closeBatch();
+		}
+		const std::size_t offset = batch.size();
+		batch.resize( offset + length);
+		batch[offset] = aMessage.getMessageType();
+		Base::storeLittleEndian( &batch[offset + 1], static_cast< std::uint16_t >( aMessage.length()));
+		aMessage.message.copy( &batch[offset + TelemetryDatagram::messageHeaderLength], aMessage.length());
+		++numberOfMessages;
+
+		// Everything that is sent before the flush runs ends up in the same datagram
+		if (!flushPosted)
+		{
+			flushPosted = true;
+			TelemetrySenderPtr self = shared_from_this();
+			boost::asio::post(	socket.get_executor(), // @suppress("Invalid arguments")
+								[self]()
+								{
+									self->flush();
+								});
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	void TelemetrySender::flush()
+	{
+		{
+			std::lock_guard< std::mutex > lock( batchBusy);
+			flushPosted = false;
+			if (numberOfMessages > 0)
+			{
+				closeBatch();
+			}
+		}
+		sendNextDatagram();
+	}
+	/**
+	 *
+	 */
+	void TelemetrySender::closeBatch()
+	{
+		// The sequence number is only stamped when the datagram is sent
+		TelemetryDatagram::encodeHeader( batch.data(), static_cast< std::uint8_t >( numberOfMessages), epoch, 0);
+		readyDatagrams.push_back( std::move( batch));
+
+		batch = std::vector< char >();
+		batch.reserve( TelemetryDatagram::maxLength);
+		batch.resize( TelemetryDatagram::headerLength);
+		numberOfMessages = 0;
+	}
+	/**
+	 *
+	 */
+	void TelemetrySender::sendNextDatagram()
+	{
+		if (sending)
+		{
+			return;
+		}
+		{
+			std::lock_guard< std::mutex > lock( batchBusy);
+			if (readyDatagrams.empty())
+			{
+				return;
+			}
+			datagram.swap( readyDatagrams.front());
+			readyDatagrams.pop_front();
+		}
+
+		if (!endpointResolved)
+		{
+			boost::system::error_code error;
+			boost::asio::ip::udp::resolver resolver( CommunicationService::getCommunicationService().getIOContext()); // @suppress("Ambiguous problem")
+			boost::asio::ip::udp::resolver::results_type results = resolver.resolve( boost::asio::ip::udp::v4(), host, std::to_string( port), error);
+			if (error || results.empty())
+			{
+				TRACE_DEVELOP( "*** TelemetrySender::sendNextDatagram: cannot resolve " + host + ": " + error.message());
+				return;
+			}
+			endpoint = *results.begin();
+			endpointResolved = true;
+			socket.open( boost::asio::ip::udp::v4(), error);
+		}
+
+		Base::storeLittleEndian( datagram.data() + 8, ++sequenceNumber); // @suppress("Avoid magic numbers")
+		sending = true;
+		TelemetrySenderPtr self = shared_from_this();
+		socket.async_send_to(	boost::asio::buffer( datagram), // @suppress("Invalid arguments")
+								endpoint,
+								[self](const boost::system::error_code& error, std::size_t UNUSEDPARAM(bytes_transferred))
+								{
+									self->sending = false;
+									if (error)
+									{
+										// Nobody waits for a lost datagram, but the address may have changed
+										TRACE_DEVELOP( "*** TelemetrySender::sendNextDatagram: " + error.message());
+										self->endpointResolved = false;
+										boost::system::error_code closeError;
+										self->socket.close( closeError);
+									}
+									self->sendNextDatagram();
+								});
+	}
+} // namespace Messaging
@@ -0,0 +1,104 @@
+#ifndef TELEMETRYSENDER_HPP_
+#define TELEMETRYSENDER_HPP_
+
+#include "Config.hpp"
+
+#include "Message.hpp"
+
+#include <boost/asio.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Messaging
+{
+	/**
+	 * Sends latest-value messages, e.g. poses, to a TelemetryReceiver over UDP.
+	 *
+	 * A lost datagram is not sent again: the next one carries a newer value anyway, so there is no
+	 * head-of-line blocking like on a TCP connection. Only use it for messages that may be lost and
+	 * that may be handled more than once. Requests like a MergeRequest go over a Connection.
+	 *
+	 * The messages that are sent before the strand of the sender gets to them are batched into one
+	 * datagram, e.g. the poses of all robots of a simulation tick.
+	 */
+	class TelemetrySender : public std::enable_shared_from_this< TelemetrySender >
+	{
+		public:
+			/**
+			 *
+			 */
+			TelemetrySender(	const std::string& aHostName,
+								unsigned short aPort);
+			/**
+			 *
+			 */
+			virtual ~TelemetrySender() = default;
+			/**
+			 * Queues aMessage for the next datagram. May be called from any thread.
+			 *
+			 * @return false if the body is too large for a datagram
+			 */
+			bool send( const Message& aMessage);
+
+		private:
+			/**
+			 * Closes the batch and sends the datagrams that are ready, on the strand
+			 */
+			void flush();
+			/**
+			 *
+			 */
+			void sendNextDatagram();
+			/**
+			 * Moves the current batch to the ready datagrams, batchBusy must be locked
+			 */
+			void closeBatch();
+			/**
+			 *
+			 */
+			std::string host;
+			/**
+			 *
+			 */
+			unsigned short port;
+			/**
+			 *
+			 */
+			boost::asio::ip::udp::socket socket;
+			/**
+			 * Resolved on the first send and again after a send failed
+			 */
+			boost::asio::ip::udp::endpoint endpoint;
+			bool endpointResolved;
+			/**
+			 * Guards batch, numberOfMessages, flushPosted and readyDatagrams
+			 */
+			std::mutex batchBusy;
+			/**
+			 * The messages of the next datagram, after room for the header
+			 */
+			std::vector< char > batch;
+			std::size_t numberOfMessages;
+			bool flushPosted;
+			/**
+			 * Complete datagrams without sequence number that wait for the datagram that is being sent
+			 */
+			std::deque< std::vector< char > > readyDatagrams;
+			/**
+			 * Only used on the strand
+			 */
+			std::vector< char > datagram;
+			bool sending;
+			std::uint32_t epoch;
+			std::uint32_t sequenceNumber;
+	};
+	// class TelemetrySender
+	typedef std::shared_ptr< TelemetrySender > TelemetrySenderPtr;
+} // namespace Messaging
+
+#endif // TELEMETRYSENDER_HPP_
@@ -0,0 +1,330 @@
+#include "ThreadPool.hpp"
+
+#include "Logger.hpp"
+
+#include <chrono>
+#include <iostream>
+
+namespace Base
+{
+	namespace
+	{
+		/**
+		 * The pool and index of the worker that runs on this thread, if any
+		 */
+		thread_local ThreadPool* currentPool = nullptr;
+		thread_local std::size_t currentWorker = 0;
+		/**
+		 * A worker that finds tasks pending but cannot get one, because the deques that hold them are
+		 * locked, yields this many times and then sleeps for doubling times up to maxBackOff
+		 */
+		const unsigned int yieldsBeforeBackOff = 8; // @suppress("Avoid magic numbers")
+		const std::chrono::microseconds minBackOff( 10); // @suppress("Avoid magic numbers")
+		const std::chrono::microseconds maxBackOff( 1000); // @suppress("Avoid magic numbers")
+	} // namespace
+	/**
+	 *
+	 */
+	/* static */ThreadPool& ThreadPool::getThreadPool()
+	{
+		static ThreadPool threadPool( std::max( 1U, std::thread::hardware_concurrency()));
+		return threadPool;
+	}
+	/**
+	 *
+	 */
+	void ThreadPool::submit( Task aTask)
+	{
+		if (currentPool == this)
+		{
+			Worker& worker = *workers[currentWorker];
+			std::lock_guard< std::mutex > lock( worker.tasksBusy);
+			worker.tasks.push_back( std::move( aTask));
+		} else
+		{
+			std::lock_guard< std::mutex > lock( injectionBusy);
+			injectionQueue.push_back( std::move( aTask));
+		}
+		++pendingTasks;
+
+		std::lock_guard< std::mutex > lock( idleBusy);
+		idleCondition.notify_one();
+	}
+	/**
+	 *
+	 */
+	bool ThreadPool::runPendingTask()
+	{
+		Task task;
+		if (popTask( currentPool == this ? currentWorker : workers.size(), task))
+		{
+			execute( task);
+			return true;
+		}
+		return false;
+	}
+	/**
+	 *
+	 */
+	ThreadPool::ThreadPool( std::size_t aNumberOfWorkers) :
+								pendingTasks( 0),
+								stopping( false)
+	{
+		for (std::size_t i = 0; i < aNumberOfWorkers; ++i)
+		{
+			workers.push_back( std::make_unique< Worker >());
+		}
+		// Only start the threads when all deques exist, they steal from each other right away
+		for (std::size_t i = 0; i < aNumberOfWorkers; ++i)
+		{
+			workers[i]->thread = std::thread( [this, i]{ run( i);});
+		}
+	}
+	/**
+	 *
+	 */
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard< std::mutex > lock( idleBusy);
+			stopping = true;
+			idleCondition.notify_all();
+		}
+		for (std::unique_ptr< Worker >& worker : workers)
+		{
+			if (worker->thread.joinable())
+			{
+				worker->thread.join();
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void ThreadPool::run( std::size_t anIndex)
+	{
+		currentPool = this;
+		currentWorker = anIndex;
+
+		unsigned int failedRounds = 0;
+		std::chrono::microseconds backOff = minBackOff;
+		for (;;)
+		{
+			Task task;
+			if (popTask( anIndex, task))
+			{
+				failedRounds = 0;
+				backOff = minBackOff;
+				execute( task);
+				continue;
+			}
+
+			std::unique_lock< std::mutex > lock( idleBusy);
+			if (stopping && pendingTasks == 0)
+			{
+				break;
+			}
+			if (pendingTasks == 0)
+			{
+				failedRounds = 0;
+				backOff = minBackOff;
+				idleCondition.wait( lock, [this]{ return stopping || pendingTasks > 0;});
+				continue;
+			}
+
+			// There is work but the steal round lost the try_lock on its deque: back off instead of
+			// spinning. A submit still wakes us early.
+			if (++failedRounds <= yieldsBeforeBackOff)
+			{
+				lock.unlock();
+				std::this_thread::yield();
+			} else
+			{
+				idleCondition.wait_for( lock, backOff);
+				backOff = std::min( backOff * 2, maxBackOff);
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	bool ThreadPool::popTask(	std::size_t anIndex,
+								Task& aTask)
+	{
+		if (pendingTasks == 0)
+		{
+			return false;
+		}
+
+		// Our own work first, newest first
+		if (anIndex < workers.size())
+		{
+			Worker& worker = *workers[anIndex];
+			std::lock_guard< std::mutex > lock( worker.tasksBusy);
+			if (!worker.tasks.empty())
+			{
+				aTask = std::move( worker.tasks.back());
+				worker.tasks.pop_back();
+				--pendingTasks;
+				return true;
+			}
+		}
+		{
+			std::lock_guard< std::mutex > lock( injectionBusy);
+			if (!injectionQueue.empty())
+			{
+				aTask = std::move( injectionQueue.front());
+				injectionQueue.pop_front();
+				--pendingTasks;
+				return true;
+			}
+		}
+		// Steal the oldest task of somebody else
+		for (std::size_t i = 1; i <= workers.size(); ++i)
+		{
+			std::size_t victim = (anIndex + i) % workers.size();
+			if (victim == anIndex)
+			{
+				continue;
+			}
+			Worker& worker = *workers[victim];
+			std::unique_lock< std::mutex > lock( worker.tasksBusy, std::try_to_lock);
+			if (lock.owns_lock() && !worker.tasks.empty())
+			{
+				aTask = std::move( worker.tasks.front());
+				worker.tasks.pop_front();
+				--pendingTasks;
+				return true;
+			}
+		}
+		return false;
+	}
+	/**
+	 *
+	 */
+	void ThreadPool::execute( Task& aTask)
+	{
+		try
+		{
+			aTask();
+		}
+		catch (std::exception& e)
+		{
+			Application::Logger::log( __PRETTY_FUNCTION__ + std::string( ": ") + e.what());
+			std::cerr << __PRETTY_FUNCTION__ << ": " << e.what() << std::endl;
+		}
+		catch (...)
+		{
+			Application::Logger::log( __PRETTY_FUNCTION__ + std::string( ": unknown exception"));
+			std::cerr << __PRETTY_FUNCTION__ << ": unknown exception" << std::endl;
+		}
+	}
+	/**
+	 *
+	 */
+	TaskGroup::TaskGroup( ThreadPool& aThreadPool) :
+								threadPool( aThreadPool),
+								pendingTasks( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	TaskGroup::~TaskGroup()
+	{
+		try
+		{
+			wait();
+		}
+		catch (...)
+		{
+		}
+	}
+	/**
+	 *
+	 */
+	void TaskGroup::run( Task aTask)
+	{
+		++pendingTasks;
+		threadPool.submit( [this, aTask]
+		{
+			std::exception_ptr exception;
+			try
+			{
+				aTask();
+			}
+			catch (...)
+			{
+				exception = std::current_exception();
+			}
+			taskDone( exception);
+		});
+	}
+	/**
+	 *
+	 */
+	void TaskGroup::then( Task aContinuation)
+	{
+		{
+			std::lock_guard< std::mutex > lock( groupBusy);
+			if (pendingTasks > 0)
+			{
+				continuation = std::move( aContinuation);
+				return;
+			}
+		}
+		threadPool.submit( std::move( aContinuation));
+	}
+	/**
+	 *
+	 */
+	void TaskGroup::wait()
+	{
+		while (pendingTasks > 0)
+		{
+			// Help instead of blocking a worker, and only sleep if there is nothing to help with
+			if (!threadPool.runPendingTask())
+			{
+				std::unique_lock< std::mutex > lock( groupBusy);
+				groupDone.wait_for( lock, std::chrono::milliseconds( 1), [this]{ return pendingTasks == 0;});
+			}
+		}
+
+		std::exception_ptr exception;
+		{
+			std::lock_guard< std::mutex > lock( groupBusy);
+			exception = firstException;
+			firstException = nullptr;
+		}
+		if (exception)
+		{
+			std::rethrow_exception( exception);
+		}
+	}
+	/**
+	 *
+	 */
+	void TaskGroup::taskDone( std::exception_ptr anException)
+	{
+		// The group may be gone as soon as the lock is released
+		ThreadPool& pool = threadPool;
+		Task next;
+		{
+			std::lock_guard< std::mutex > lock( groupBusy);
+			if (anException && !firstException)
+			{
+				firstException = anException;
+			}
+			if (--pendingTasks == 0)
+			{
+				next = std::move( continuation);
+				continuation = nullptr;
+				groupDone.notify_all();
+			}
+		}
+		if (next)
+		{
+			pool.submit( std::move( next));
+		}
+	}
+} // namespace Base
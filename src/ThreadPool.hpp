@@ -0,0 +1,215 @@
+#ifndef THREADPOOL_HPP_
+#define THREADPOOL_HPP_
+
+#include "Config.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Base
+{
+	/**
+	 *
+	 */
+	typedef std::function< void() > Task;
+
+	/**
+	 * The general executor of the application, sized from the hardware concurrency.
+	 *
+	 * Every worker has its own deque. A task submitted by a worker goes to the back of that worker's
+	 * deque and the worker takes its next task from the back again (the most recent, cache warm one).
+	 * A task submitted by any other thread goes to a shared injection queue. A worker that runs out of
+	 * work takes from the injection queue and then steals from the front of the other workers' deques,
+	 * so the oldest, and usually largest, pieces of work are the ones that move between threads.
+	 *
+	 * Use a TaskGroup to wait for a number of tasks and parallelFor to spread a loop over the workers.
+	 */
+	class ThreadPool
+	{
+		public:
+			/**
+			 *
+			 */
+			static ThreadPool& getThreadPool();
+			/**
+			 * Schedules aTask, an exception that escapes from aTask is logged
+			 */
+			void submit( Task aTask);
+			/**
+			 * Runs one waiting task on the calling thread
+			 *
+			 * @return false if there was nothing to run
+			 */
+			bool runPendingTask();
+			/**
+			 *
+			 */
+			std::size_t getNumberOfWorkers() const
+			{
+				return workers.size();
+			}
+
+		protected:
+			/**
+			 *
+			 */
+			explicit ThreadPool( std::size_t aNumberOfWorkers);
+			/**
+			 * Runs the tasks that are still waiting and then stops the workers
+			 */
+			virtual ~ThreadPool();
+
+		private:
+			/**
+			 *
+			 */
+			struct Worker
+			{
+					std::mutex tasksBusy;
+					std::deque< Task > tasks;
+					std::thread thread;
+			};
+			/**
+			 * The body of worker anIndex
+			 */
+			void run( std::size_t anIndex);
+			/**
+			 * Finds the next task for worker anIndex, or for a thread outside the pool if anIndex
+			 * is the number of workers
+			 */
+			bool popTask(	std::size_t anIndex,
+							Task& aTask);
+			/**
+			 *
+			 */
+			void execute( Task& aTask);
+			/**
+			 *
+			 */
+			std::vector< std::unique_ptr< Worker > > workers;
+			/**
+			 *
+			 */
+			std::mutex injectionBusy;
+			std::deque< Task > injectionQueue;
+			/**
+			 * The number of submitted tasks that were not picked up yet
+			 */
+			std::atomic< std::size_t > pendingTasks;
+			/**
+			 *
+			 */
+			std::atomic< bool > stopping;
+			/**
+			 * Idle workers park here
+			 */
+			std::mutex idleBusy;
+			std::condition_variable idleCondition;
+	};
+	// class ThreadPool
+
+	/**
+	 * A number of tasks that can be waited for as a whole.
+	 *
+	 * wait() runs waiting tasks of the pool while the group is not done, so it is safe to wait for a
+	 * group from within a task. The first exception thrown by a task of the group is rethrown by wait().
+	 */
+	class TaskGroup
+	{
+		public:
+			/**
+			 *
+			 */
+			explicit TaskGroup( ThreadPool& aThreadPool = ThreadPool::getThreadPool());
+			/**
+			 * Waits for the tasks of the group, an exception of a task is swallowed here
+			 */
+			~TaskGroup();
+			/**
+			 *
+			 */
+			TaskGroup( const TaskGroup& aTaskGroup) = delete;
+			/**
+			 *
+			 */
+			TaskGroup& operator=( const TaskGroup& aTaskGroup) = delete;
+			/**
+			 *
+			 */
+			void run( Task aTask);
+			/**
+			 * aContinuation is submitted to the pool as soon as all tasks that were run in the group
+			 * are done, immediately if they already are. The continuation is not part of the group,
+			 * it must not refer to the group because the group may be gone by the time it runs.
+			 */
+			void then( Task aContinuation);
+			/**
+			 *
+			 */
+			void wait();
+
+		private:
+			/**
+			 *
+			 */
+			void taskDone( std::exception_ptr anException);
+
+			ThreadPool& threadPool;
+			std::atomic< std::size_t > pendingTasks;
+			std::mutex groupBusy;
+			std::condition_variable groupDone;
+			std::exception_ptr firstException;
+			Task continuation;
+	};
+	// class TaskGroup
+
+	/**
+	 * Calls aFunction( i) for every i in [aBegin, aEnd), spread over the workers of the pool in chunks
+	 * of at least aGrainSize indexes. The calling thread does its share, so this may be called from a task.
+	 */
+	template< typename F >
+	void parallelFor(	std::size_t aBegin,
+						std::size_t aEnd,
+						const F& aFunction,
+						std::size_t aGrainSize = 1,
+						ThreadPool& aThreadPool = ThreadPool::getThreadPool())
+	{
+		if (aBegin >= aEnd)
+		{
+			return;
+		}
+		const std::size_t count = aEnd - aBegin;
+		// A few chunks per worker so the stealing can even out chunks that take longer
+		const std::size_t maxChunks = 4 * (aThreadPool.getNumberOfWorkers() + 1); // @suppress("Avoid magic numbers")
+		const std::size_t chunks = std::max< std::size_t >( 1, std::min( maxChunks, count / std::max< std::size_t >( 1, aGrainSize)));
+		const std::size_t chunkSize = (count + chunks - 1) / chunks;
+
+		TaskGroup group( aThreadPool);
+		for (std::size_t start = aBegin + chunkSize; start < aEnd; start += chunkSize)
+		{
+			const std::size_t end = std::min( start + chunkSize, aEnd);
+			group.run( [start, end, &aFunction]
+			{
+				for (std::size_t i = start; i < end; ++i)
+				{
+					aFunction( i);
+				}
+			});
+		}
+		for (std::size_t i = aBegin; i < std::min( aBegin + chunkSize, aEnd); ++i)
+		{
+			aFunction( i);
+		}
+		group.wait();
+	}
+} // namespace Base
+#endif // THREADPOOL_HPP_
@@ -1,6 +1,7 @@
 #include "WayPoint.hpp"
 
 #include "Logger.hpp"
+#include "RobotWorld.hpp"
 
 #include <sstream>
 
@@ -10,7 +11,8 @@ namespace Model
 	 *
 	 */
 	WayPoint::WayPoint( const std::string& aName) :
-								name( aName)
+								name( aName),
+								nameId( Base::SymbolTable::intern( aName))
 	{
 	}
 	/**
@@ -19,6 +21,7 @@ namespace Model
 	WayPoint::WayPoint( const std::string& aName,
 						const wxPoint& aPosition) :
 								name( aName),
+								nameId( Base::SymbolTable::intern( aName)),
 								position( aPosition)
 	{
 	}
@@ -28,7 +31,10 @@ namespace Model
 	void WayPoint::setName( const std::string& aName,
 							bool aNotifyObservers /*= true*/)
 	{
+		Base::SymbolId oldNameId = nameId;
 		name = aName;
+		nameId = Base::SymbolTable::intern( aName);
+		RobotWorld::getRobotWorld().updateNameIndex( getObjectId(), oldNameId, nameId);
 		if (aNotifyObservers == true)
 		{
 			notifyObservers();
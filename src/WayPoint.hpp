@@ -6,6 +6,7 @@
 #include "ModelObject.hpp"
 #include "Point.hpp"
 #include "Region.hpp"
+#include "SymbolTable.hpp"
 
 namespace Model
 {
@@ -27,10 +28,18 @@ namespace Model
 			/**
 			 *
 			 */
-			std::string getName() const
+			const std::string& getName() const
 			{
 				return name;
 			}
+			/**
+			 *
+			 * @return the interned name, cheap to compare and hash
+			 */
+			Base::SymbolId getNameId() const
+			{
+				return nameId;
+			}
 			/**
 			 *
 			 */
@@ -81,6 +90,7 @@ namespace Model
 		protected:
 		private:
 			std::string name;
+			Base::SymbolId nameId;
 		wxSize size;
 			wxPoint position;
 	};
@@ -4,13 +4,16 @@
 #include "Config.hpp"
 
 #include <wx/app.h>
+#include <wx/bitmap.h>
 #include <wx/brush.h>
 #include <wx/button.h>
 #include <wx/checkbox.h>
 #include <wx/colour.h>
 #include <wx/cursor.h>
 #include <wx/dc.h>
+#include <wx/dcbuffer.h>
 #include <wx/dcclient.h>
+#include <wx/dcmemory.h>
 #include <wx/defs.h>
 #include <wx/dnd.h>
 #include <wx/event.h>
@@ -31,6 +34,7 @@
 #include <wx/statline.h>
 #include <wx/stattext.h>
 #include <wx/string.h>
+#include <wx/timer.h>
 #include <wx/toolbar.h>
 #include <wx/treebase.h>
 #include <wx/validate.h>
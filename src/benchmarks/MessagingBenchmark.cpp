@@ -0,0 +1,187 @@
+#include "Config.hpp"
+
+#include "Client.hpp"
+#include "CommunicationService.hpp"
+#include "MessageHandler.hpp"
+#include "MessageTypes.hpp"
+#include "Server.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// \file
+//
+// Two-process echo benchmark of the messaging layer.
+//
+// The parent forks and executes itself as an echo server, then measures
+// - the latency of sequential round trips with a small body and
+// - the throughput of pipelined requests with a 1 KiB body.
+//
+// Usage: messagingbenchmark tcp|unix|shm [rounds [messages]]
+//
+//  tcp  TCP over the loopback interface, shared memory disabled
+//  unix a Unix domain socket, shared memory disabled
+//  shm  TCP for the hand-shake, the shared memory channel for the messages
+//
+// It is not part of the robotworld build. From the src directory:
+//
+//  g++ -std=c++17 -O2 -I. `wx-config --cxxflags` benchmarks/MessagingBenchmark.cpp \
+//      Clock.cpp CommunicationService.cpp Connection.cpp Logger.cpp Server.cpp \
+//      SharedMemoryChannel.cpp SharedMemorySession.cpp StdOutTraceFunction.cpp \
+//      TelemetryReceiver.cpp TelemetrySender.cpp ThreadPool.cpp Trace.cpp \
+//      -lpthread -lrt -o messagingbenchmark
+
+namespace
+{
+	/**
+	 * Echoes requests and counts the responses
+	 */
+	class EchoHandler : public Messaging::MessageHandler
+	{
+		public:
+			/**
+			 *
+			 */
+			virtual void handleRequest( Messaging::Message& aMessage) override
+			{
+				aMessage.setMessageType( Messaging::EchoResponse);
+			}
+			/**
+			 *
+			 */
+			virtual void handleResponse( const Messaging::Message& aMessage) override
+			{
+				if (aMessage.getMessageType() != Messaging::EchoResponse)
+				{
+					++unexpected;
+				}
+				bytes += aMessage.length();
+				++responses;
+			}
+
+			std::atomic< unsigned long > responses{ 0};
+			std::atomic< unsigned long > bytes{ 0};
+			std::atomic< unsigned long > unexpected{ 0};
+	};
+	// class EchoHandler
+
+	/**
+	 *
+	 */
+	void waitForResponses(	const EchoHandler& aHandler,
+							unsigned long aNumberOfResponses)
+	{
+		while (aHandler.responses.load() < aNumberOfResponses)
+		{
+			std::this_thread::yield();
+		}
+	}
+	/**
+	 *
+	 */
+	int runServer( const std::string& anAddress)
+	{
+		Messaging::CommunicationService::getCommunicationService().registerServer( std::make_shared< Messaging::Server >( Messaging::Address::parse( anAddress), std::make_shared< EchoHandler >()));
+		// The parent kills the server when it is done
+		for (;;)
+		{
+			std::this_thread::sleep_for( std::chrono::seconds( 1));
+		}
+	}
+	/**
+	 *
+	 */
+	int runClient(	const char* aProgram,
+					const std::string& aMode,
+					unsigned long aNumberOfRounds,
+					unsigned long aNumberOfMessages)
+	{
+		const std::string address = aMode == "unix" ? "unix:///tmp/messagingbenchmark-" + std::to_string( ::getpid()) + ".sock" : "tcp://localhost:" + std::to_string( 24000 + ::getpid() % 1000); // @suppress("Avoid magic numbers")
+		if (aMode != "shm")
+		{
+			Messaging::CommunicationService::setSharedMemoryEnabled( false);
+		}
+
+		const pid_t server = ::fork();
+		if (server == 0)
+		{
+			::execl( aProgram, aProgram, "server", address.c_str(), static_cast< char* >( nullptr));
+			std::_Exit( EXIT_FAILURE);
+		}
+		std::this_thread::sleep_for( std::chrono::milliseconds( 300)); // @suppress("Avoid magic numbers")
+
+		auto handler = std::make_shared< EchoHandler >();
+		const Messaging::Address serverAddress = Messaging::Address::parse( address);
+
+		Messaging::Client( serverAddress, handler).dispatchMessage( Messaging::Message( Messaging::EchoRequest, "warm-up"));
+		waitForResponses( *handler, 1);
+
+		const std::string smallBody( 42, 'x'); // @suppress("Avoid magic numbers")
+		handler->responses = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned long round = 0; round < aNumberOfRounds; ++round)
+		{
+			Messaging::Client( serverAddress, handler).dispatchMessage( Messaging::Message( Messaging::EchoRequest, smallBody));
+			waitForResponses( *handler, round + 1);
+		}
+		const double roundTrip = std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now() - start).count() / aNumberOfRounds;
+
+		const std::string largeBody( 1024, 'y'); // @suppress("Avoid magic numbers")
+		handler->responses = 0;
+		handler->bytes = 0;
+		start = std::chrono::steady_clock::now();
+		for (unsigned long message = 0; message < aNumberOfMessages; ++message)
+		{
+			Messaging::Client( serverAddress, handler).dispatchMessage( Messaging::Message( Messaging::EchoRequest, largeBody));
+		}
+		waitForResponses( *handler, aNumberOfMessages);
+		const double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start).count();
+
+		std::cout << aMode << ": round trip " << roundTrip << " us, pipelined 1 KiB " << aNumberOfMessages / seconds << " msg/s " << 2.0 * handler->bytes.load() / seconds / 1e6 << " MB/s (both ways), unexpected responses " << handler->unexpected.load() << std::endl; // @suppress("Avoid magic numbers")
+
+		::kill( server, SIGKILL);
+		::waitpid( server, nullptr, 0);
+		if (aMode == "unix")
+		{
+			::unlink( serverAddress.socketPath.c_str());
+		}
+		return handler->unexpected.load() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+} // namespace
+
+/**
+ *
+ */
+int main( 	int argc,
+			char* argv[])
+{
+	try
+	{
+		if (argc == 3 && std::string( argv[1]) == "server")
+		{
+			return runServer( argv[2]);
+		}
+		if (argc >= 2 && (std::string( argv[1]) == "tcp" || std::string( argv[1]) == "unix" || std::string( argv[1]) == "shm"))
+		{
+			const unsigned long rounds = argc > 2 ? std::stoul( argv[2]) : 20000; // @suppress("Avoid magic numbers")
+			const unsigned long messages = argc > 3 ? std::stoul( argv[3]) : 100000; // @suppress("Avoid magic numbers")
+			// The io_context threads are still running, do not wait for them
+			std::cout.flush();
+			std::_Exit( runClient( argv[0], argv[1], rounds, messages));
+		}
+		std::cerr << "Usage: " << argv[0] << " tcp|unix|shm [rounds [messages]]" << std::endl;
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << __PRETTY_FUNCTION__ << ": " << e.what() << std::endl;
+	}
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,152 @@
+#include "Config.hpp"
+
+#include "Queue.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+// \file
+//
+// Throughput of Base::Queue against the mutex and std::queue it replaced.
+//
+// N producer threads enqueue a total number of longs, one consumer thread dequeues them, one at a
+// time and in batches of 64. Every configuration is run a number of times and the average
+// throughput in millions of elements per second is printed.
+//
+// Usage: queuebenchmark [capacity [elements [runs]]]
+//
+// It is not part of the robotworld build. From the src directory:
+//
+//  g++ -std=c++17 -O2 -I. `wx-config --cxxflags` benchmarks/QueueBenchmark.cpp -lpthread -o queuebenchmark
+
+namespace
+{
+	/**
+	 * The unbounded queue that Base::Queue used to be
+	 */
+	template< typename QueueContentType >
+	class MutexQueue
+	{
+		public:
+			/**
+			 *
+			 */
+			void enqueue( const QueueContentType& anElement)
+			{
+				std::unique_lock< std::mutex > lock( queueBusy);
+				queue.push( anElement);
+				queueFull.notify_one();
+			}
+			/**
+			 *
+			 */
+			std::optional< QueueContentType > dequeue()
+			{
+				std::unique_lock< std::mutex > lock( queueBusy);
+				while (queue.empty())
+				{
+					queueFull.wait( lock);
+				}
+				QueueContentType front = queue.front();
+				queue.pop();
+				return front;
+			}
+
+		private:
+			std::queue< QueueContentType > queue;
+			std::mutex queueBusy;
+			std::condition_variable queueFull;
+	};
+	// class MutexQueue
+
+	/**
+	 * @return Millions of elements per second
+	 */
+	template< typename Queue, typename Consume >
+	double measure(	Queue& aQueue,
+					unsigned int aNumberOfProducers,
+					long aNumberOfElements,
+					Consume aConsume)
+	{
+		const long perProducer = aNumberOfElements / aNumberOfProducers;
+		const long total = perProducer * aNumberOfProducers;
+
+		const auto start = std::chrono::steady_clock::now();
+		std::vector< std::thread > producers;
+		for (unsigned int producer = 0; producer < aNumberOfProducers; ++producer)
+		{
+			producers.emplace_back( [&aQueue, perProducer]()
+			{
+				for (long element = 0; element < perProducer; ++element)
+				{
+					aQueue.enqueue( element);
+				}
+			});
+		}
+		long consumed = 0;
+		while (consumed < total)
+		{
+			consumed += aConsume( aQueue);
+		}
+		for (std::thread& producer : producers)
+		{
+			producer.join();
+		}
+		return total / std::chrono::duration< double >( std::chrono::steady_clock::now() - start).count() / 1e6; // @suppress("Avoid magic numbers")
+	}
+} // namespace
+
+/**
+ *
+ */
+int main( 	int argc,
+			char* argv[])
+{
+	const std::size_t capacity = argc > 1 ? std::stoul( argv[1]) : 16384; // @suppress("Avoid magic numbers")
+	const long elements = argc > 2 ? std::stol( argv[2]) : 4000000; // @suppress("Avoid magic numbers")
+	const unsigned int runs = argc > 3 ? static_cast< unsigned int >( std::stoul( argv[3])) : 3; // @suppress("Avoid magic numbers")
+
+	auto one = []( auto& aQueue) -> long
+	{
+		return aQueue.dequeue() ? 1 : 0;
+	};
+	auto batch = []( auto& aQueue) -> long
+	{
+		long buffer[64]; // @suppress("Avoid magic numbers")
+		return static_cast< long >( aQueue.dequeue( buffer, 64)); // @suppress("Avoid magic numbers")
+	};
+
+	std::printf( "capacity %zu, %ld elements, Mops/s averaged over %u runs\n", capacity, elements, runs);
+	std::printf( "producers  mutex queue  Base::Queue  Base::Queue batch of 64\n");
+	for (unsigned int producers : { 1, 2, 4, 8, 16 }) // @suppress("Avoid magic numbers")
+	{
+		double mutexQueue = 0;
+		double queue = 0;
+		double queueBatch = 0;
+		for (unsigned int run = 0; run < runs; ++run)
+		{
+			{
+				MutexQueue< long > q;
+				mutexQueue += measure( q, producers, elements, one);
+			}
+			{
+				Base::Queue< long > q( capacity);
+				queue += measure( q, producers, elements, one);
+			}
+			{
+				Base::Queue< long > q( capacity);
+				queueBatch += measure( q, producers, elements, batch);
+			}
+		}
+		std::printf( "%9u  %11.2f  %11.2f  %23.2f\n", producers, mutexQueue / runs, queue / runs, queueBatch / runs);
+	}
+	return EXIT_SUCCESS;
+}